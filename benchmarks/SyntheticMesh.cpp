@@ -0,0 +1,48 @@
+#include "SyntheticMesh.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+namespace di_renderer::benchmarks {
+    io::ObjData make_uv_sphere(const std::size_t rings, const std::size_t segments) {
+        io::ObjData data;
+        const std::size_t columns = segments + 1;
+        const std::size_t vertex_count = (rings + 1) * columns;
+        data.vertices.reserve(vertex_count);
+        data.texture_vertices.reserve(vertex_count);
+        data.normals.reserve(vertex_count);
+
+        for (std::size_t ring = 0; ring <= rings; ++ring) {
+            const double theta = M_PI * static_cast<double>(ring) / static_cast<double>(rings);
+            for (std::size_t segment = 0; segment <= segments; ++segment) {
+                const double phi = 2.0 * M_PI * static_cast<double>(segment) / static_cast<double>(segments);
+                const math::Vector3 position(static_cast<float>(std::sin(theta) * std::cos(phi)),
+                                             static_cast<float>(std::cos(theta)),
+                                             static_cast<float>(std::sin(theta) * std::sin(phi)));
+                data.vertices.push_back(position);
+                data.normals.push_back(position);
+                data.texture_vertices.emplace_back(static_cast<float>(segment) / static_cast<float>(segments),
+                                                   1.0f - (static_cast<float>(ring) / static_cast<float>(rings)));
+            }
+        }
+
+        std::vector<core::FaceVerticeData> corners;
+        std::vector<std::uint32_t> offsets;
+        corners.reserve(rings * segments * 4);
+        offsets.reserve((rings * segments) + 1);
+        offsets.push_back(0);
+        for (std::size_t ring = 0; ring < rings; ++ring) {
+            for (std::size_t segment = 0; segment < segments; ++segment) {
+                const auto top = static_cast<int>((ring * columns) + segment);
+                const auto bottom = static_cast<int>(((ring + 1) * columns) + segment);
+                for (const int index : {top, top + 1, bottom + 1, bottom}) {
+                    corners.push_back({index, index, index});
+                }
+                offsets.push_back(static_cast<std::uint32_t>(corners.size()));
+            }
+        }
+        data.faces = core::FaceList(std::move(corners), std::move(offsets));
+        return data;
+    }
+} // namespace di_renderer::benchmarks
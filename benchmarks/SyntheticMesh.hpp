@@ -0,0 +1,12 @@
+#pragma once
+
+#include "io/ObjData.hpp"
+
+#include <cstddef>
+
+namespace di_renderer::benchmarks {
+    // Unit UV sphere of rings x segments quads, with a texture coordinate and a normal per vertex and a
+    // duplicated seam column like exporters write it. Faces are counter-clockwise seen from outside.
+    // Deterministic, so results of different runs and machines describe the same input.
+    io::ObjData make_uv_sphere(std::size_t rings, std::size_t segments);
+} // namespace di_renderer::benchmarks
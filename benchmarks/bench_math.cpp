@@ -0,0 +1,162 @@
+// Matrix4x4 kernels against the straightforward element-accessor implementations they replaced.
+// Prints one line per kernel and fails if the results disagree.
+
+#include "math/Matrix4x4.hpp"
+#include "math/Vector4.hpp"
+
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using di_renderer::math::Matrix4x4;
+using di_renderer::math::Vector4;
+
+namespace {
+    constexpr std::size_t MATRIX_COUNT = 1024;
+    constexpr int ROUNDS = 200;
+
+    Matrix4x4 reference_multiply(const Matrix4x4& lhs, const Matrix4x4& rhs) {
+        return Matrix4x4([&](int row, int col) {
+            float result = 0;
+            for (int k = 0; k < 4; k++) {
+                result += lhs(row, k) * rhs(k, col);
+            }
+            return result;
+        });
+    }
+
+    Vector4 reference_multiply(const Matrix4x4& m, const Vector4& v) {
+        return {(m(0, 0) * v.x) + (m(0, 1) * v.y) + (m(0, 2) * v.z) + (m(0, 3) * v.w),
+                (m(1, 0) * v.x) + (m(1, 1) * v.y) + (m(1, 2) * v.z) + (m(1, 3) * v.w),
+                (m(2, 0) * v.x) + (m(2, 1) * v.y) + (m(2, 2) * v.z) + (m(2, 3) * v.w),
+                (m(3, 0) * v.x) + (m(3, 1) * v.y) + (m(3, 2) * v.z) + (m(3, 3) * v.w)};
+    }
+
+    Matrix4x4 reference_transposed(const Matrix4x4& m) {
+        return Matrix4x4([&](int row, int col) { return m(col, row); });
+    }
+
+    float reference_cofactor(const Matrix4x4& m, const int skip_row, const int skip_col) {
+        std::array<int, 3> rows{};
+        std::array<int, 3> cols{};
+        for (int i = 0, r = 0, c = 0; i < 4; ++i) {
+            if (i != skip_row) {
+                rows.at(r++) = i;
+            }
+            if (i != skip_col) {
+                cols.at(c++) = i;
+            }
+        }
+        const auto at = [&](const int r, const int c) { return m(rows.at(r), cols.at(c)); };
+        const float det = (at(0, 0) * ((at(1, 1) * at(2, 2)) - (at(1, 2) * at(2, 1)))) -
+                          (at(0, 1) * ((at(1, 0) * at(2, 2)) - (at(1, 2) * at(2, 0)))) +
+                          (at(0, 2) * ((at(1, 0) * at(2, 1)) - (at(1, 1) * at(2, 0))));
+        return (skip_row + skip_col) % 2 == 0 ? det : -det;
+    }
+
+    Matrix4x4 reference_inverse(const Matrix4x4& m) {
+        float det = 0.0f;
+        for (int col = 0; col < 4; ++col) {
+            det += m(0, col) * reference_cofactor(m, 0, col);
+        }
+        const float inv_det = 1.0f / det;
+        return Matrix4x4([&](int row, int col) { return reference_cofactor(m, col, row) * inv_det; });
+    }
+
+    bool close(const Matrix4x4& lhs, const Matrix4x4& rhs, const float tolerance) {
+        for (std::size_t i = 0; i < 16; ++i) {
+            const float a = lhs.data()[i]; // NOLINT(*-pointer-arithmetic)
+            const float b = rhs.data()[i]; // NOLINT(*-pointer-arithmetic)
+            if (std::abs(a - b) > tolerance * std::max(1.0f, std::abs(b))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Runs body ROUNDS times over all inputs and returns nanoseconds per call
+    template <typename Body> double measure(const Body& body) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int round = 0; round < ROUNDS; ++round) {
+            body();
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / (ROUNDS * static_cast<double>(MATRIX_COUNT));
+    }
+
+    void report(const char* name, const double reference_ns, const double current_ns) {
+        std::printf("%-12s reference %8.2f ns  current %8.2f ns  speedup %5.2fx\n", name, reference_ns, current_ns,
+                    reference_ns / current_ns);
+    }
+} // namespace
+
+int main() {
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+
+    std::vector<Matrix4x4> matrices;
+    std::vector<Vector4> vectors;
+    for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+        std::array<float, 16> values{};
+        for (float& value : values) {
+            value = dist(rng);
+        }
+        matrices.emplace_back(values);
+        vectors.emplace_back(dist(rng), dist(rng), dist(rng), 1.0f);
+    }
+
+    bool ok = true;
+    for (std::size_t i = 0; i + 1 < MATRIX_COUNT; ++i) {
+        const Matrix4x4& a = matrices[i];
+        const Matrix4x4& b = matrices[i + 1];
+        ok = ok && (a * b) == reference_multiply(a, b) && a.transposed() == reference_transposed(a) &&
+             (a * vectors[i]) == reference_multiply(a, vectors[i]);
+        if (std::abs(a.determinant()) > 1e-2f) {
+            ok = ok && close(a.inverse(), reference_inverse(a), 1e-3f);
+        }
+    }
+
+    std::vector<Matrix4x4> out(MATRIX_COUNT);
+    std::vector<Vector4> out_vectors(MATRIX_COUNT);
+    const auto run_multiply = [&](const auto& multiply) {
+        return measure([&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out[i] = multiply(matrices[i], matrices[(i + 1) % MATRIX_COUNT]);
+            }
+        });
+    };
+    report("multiply", run_multiply([](const auto& a, const auto& b) { return reference_multiply(a, b); }),
+           run_multiply([](const auto& a, const auto& b) { return a * b; }));
+
+    const auto run_vector = [&](const auto& multiply) {
+        return measure([&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out_vectors[i] = multiply(matrices[i], vectors[i]);
+            }
+        });
+    };
+    report("mat*vec", run_vector([](const auto& m, const auto& v) { return reference_multiply(m, v); }),
+           run_vector([](const auto& m, const auto& v) { return m * v; }));
+
+    const auto run_unary = [&](const auto& op) {
+        return measure([&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out[i] = op(matrices[i]);
+            }
+        });
+    };
+    report("transpose", run_unary([](const auto& m) { return reference_transposed(m); }),
+           run_unary([](const auto& m) { return m.transposed(); }));
+    report("inverse", run_unary([](const auto& m) { return reference_inverse(m); }),
+           run_unary([](const auto& m) { return m.inverse(); }));
+
+    if (!ok) {
+        std::puts("results differ from the reference implementation");
+        return 1;
+    }
+    return 0;
+}
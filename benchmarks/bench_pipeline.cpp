@@ -0,0 +1,351 @@
+// Load-to-draw pipeline on a synthetic UV sphere: OBJ reading and writing, triangulation, vertex normals, the
+// matrix kernels, Transform::get_matrix and the vertex assembly done on every upload.
+// Prints a table, or with --json the same results as one JSON document, and fails if a stage produces a mesh
+// that differs from the generated one.
+
+#include "SyntheticMesh.hpp"
+#include "core/Mesh.hpp"
+#include "io/ObjReader.hpp"
+#include "io/ObjWriter.hpp"
+#include "jobs/JobSystem.hpp"
+#include "math/BatchTransforms.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Transform.hpp"
+#include "math/Vector4.hpp"
+#include "render/Triangle.hpp"
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <exception>
+#include <filesystem>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+using namespace di_renderer;
+namespace fs = std::filesystem;
+
+namespace {
+    constexpr std::string_view USAGE = R"(Usage: bench_pipeline [options]
+
+Options:
+  --size N          sphere rings, the sphere has N x 2N quads, 256 by default
+  --min-time S      seconds each benchmark runs at least, 0.5 by default
+  --filter TEXT     only run benchmarks whose name contains TEXT
+  --json FILE       write the results as JSON to FILE, - for standard output instead of the table
+)";
+
+    constexpr int MIN_ITERATIONS = 3;
+    constexpr int MAX_ITERATIONS = 10000;
+    constexpr std::size_t MATRIX_COUNT = 1024;
+
+    struct Options {
+        std::size_t rings = 256;
+        double min_time_s = 0.5;
+        std::string filter;
+        std::string json;
+    };
+
+    struct Result {
+        std::string name;
+        // what items counts: bytes, vertices, faces, matrices, ...
+        const char* unit;
+        double items;
+        int iterations;
+        double median_ms;
+        double min_ms;
+    };
+
+    class Runner {
+      public:
+        Runner(const double min_time_s, std::string filter) : m_min_time_s(min_time_s), m_filter(std::move(filter)) {}
+
+        // Times body alone, setup runs before every iteration and prepares what body consumes. One untimed
+        // warm-up iteration comes first, then iterations continue until min_time_s has been spent in body.
+        template <typename Setup, typename Body>
+        void run(const std::string& name, const char* unit, const double items, const Setup& setup, const Body& body) {
+            if (!m_filter.empty() && name.find(m_filter) == std::string::npos) {
+                return;
+            }
+            using Clock = std::chrono::steady_clock;
+            setup();
+            body();
+
+            std::vector<double> samples_ms;
+            double total_ms = 0.0;
+            while (samples_ms.size() < MIN_ITERATIONS ||
+                   (total_ms < m_min_time_s * 1000.0 && samples_ms.size() < MAX_ITERATIONS)) {
+                setup();
+                const auto start = Clock::now();
+                body();
+                const double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+                samples_ms.push_back(elapsed_ms);
+                total_ms += elapsed_ms;
+            }
+
+            std::sort(samples_ms.begin(), samples_ms.end());
+            const std::size_t middle = samples_ms.size() / 2;
+            const double median_ms = samples_ms.size() % 2 == 0 ? (samples_ms[middle - 1] + samples_ms[middle]) / 2
+                                                                 : samples_ms[middle];
+            m_results.push_back({name, unit, items, static_cast<int>(samples_ms.size()), median_ms, samples_ms[0]});
+        }
+
+        template <typename Body>
+        void run(const std::string& name, const char* unit, const double items, const Body& body) {
+            run(name, unit, items, [] {}, body);
+        }
+
+        const std::vector<Result>& results() const noexcept {
+            return m_results;
+        }
+
+      private:
+        double m_min_time_s;
+        std::string m_filter;
+        std::vector<Result> m_results;
+    };
+
+    double items_per_second(const Result& result) {
+        return result.median_ms > 0.0 ? result.items / (result.median_ms / 1000.0) : 0.0;
+    }
+
+    void print_table(const std::vector<Result>& results) {
+        std::printf("%-24s %10s %10s %12s %12s %s\n", "benchmark", "median ms", "min ms", "iterations", "items/s",
+                    "unit");
+        for (const auto& result : results) {
+            std::printf("%-24s %10.3f %10.3f %12d %12.4g %s\n", result.name.c_str(), result.median_ms, result.min_ms,
+                        result.iterations, items_per_second(result), result.unit);
+        }
+    }
+
+    // Names and units are plain identifiers, nothing needs escaping
+    void write_json(std::FILE* file, const std::vector<Result>& results, const io::ObjData& sphere,
+                    const std::size_t obj_bytes) {
+        std::fprintf(file, "{\n  \"threads\": %zu,\n", jobs::JobSystem::global().get_thread_count());
+        std::fprintf(file, "  \"mesh\": {\"vertices\": %zu, \"faces\": %zu, \"obj_bytes\": %zu},\n",
+                     sphere.vertices.size(), sphere.faces.size(), obj_bytes);
+        std::fputs("  \"benchmarks\": [\n", file);
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& result = results[i];
+            std::fprintf(file,
+                         "    {\"name\": \"%s\", \"unit\": \"%s\", \"items\": %.0f, \"iterations\": %d, "
+                         "\"median_ms\": %.6f, \"min_ms\": %.6f, \"items_per_second\": %.6g}%s\n",
+                         result.name.c_str(), result.unit, result.items, result.iterations, result.median_ms,
+                         result.min_ms, items_per_second(result), i + 1 < results.size() ? "," : "");
+        }
+        std::fputs("  ]\n}\n", file);
+    }
+
+    double parse_number(const std::string& text) {
+        std::size_t used = 0;
+        const double value = std::stod(text, &used);
+        if (used != text.size() || value < 0.0) {
+            throw std::invalid_argument(text);
+        }
+        return value;
+    }
+
+    // Throws std::invalid_argument on malformed arguments, returns false for --help
+    bool parse_options(const int argc, char** argv, Options& options) {
+        const std::vector<std::string> args(argv + 1, argv + argc); // NOLINT(*-pointer-arithmetic)
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            const auto next = [&]() -> const std::string& {
+                if (i + 1 >= args.size()) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return args[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                return false;
+            }
+            if (arg == "--size") {
+                options.rings = static_cast<std::size_t>(parse_number(next()));
+                if (options.rings < 2) {
+                    throw std::invalid_argument("--size must be at least 2");
+                }
+            } else if (arg == "--min-time") {
+                options.min_time_s = parse_number(next());
+            } else if (arg == "--filter") {
+                options.filter = next();
+            } else if (arg == "--json") {
+                options.json = next();
+            } else {
+                throw std::invalid_argument("unknown option " + arg);
+            }
+        }
+        return true;
+    }
+
+    core::Mesh make_mesh(io::ObjData data) {
+        return {std::move(data.vertices), std::move(data.texture_vertices), std::move(data.normals),
+                std::move(data.faces)};
+    }
+
+    bool run_io(Runner& runner, const io::ObjData& sphere, const fs::path& obj_path, std::size_t& obj_bytes) {
+        const core::Mesh mesh = make_mesh(sphere);
+        io::ObjWriter::write_file(obj_path.string(), mesh);
+        obj_bytes = static_cast<std::size_t>(fs::file_size(obj_path));
+        const auto bytes = static_cast<double>(obj_bytes);
+
+        // the mesh is triangulated by now, so the file read back has twice the faces of the sphere
+        const std::size_t written_faces = mesh.faces.size();
+        bool ok = true;
+        const auto read = [&](const io::ObjReadMode mode) {
+            const io::ObjData data = io::ObjReader::read_file(obj_path.string(), mode);
+            ok = ok && data.vertices.size() == sphere.vertices.size() && data.faces.size() == written_faces;
+        };
+        runner.run("obj_read_stream", "bytes", bytes, [&] { read(io::ObjReadMode::STREAM); });
+        runner.run("obj_read_mapped", "bytes", bytes, [&] { read(io::ObjReadMode::MAPPED); });
+        runner.run("obj_read_parallel", "bytes", bytes, [&] { read(io::ObjReadMode::PARALLEL); });
+        runner.run("obj_write", "bytes", bytes, [&] { io::ObjWriter::write_file(obj_path.string(), mesh); });
+        runner.run("obj_write_parallel", "bytes", bytes,
+                   [&] { io::ObjWriter::write_file(obj_path.string(), mesh, false, {0, true}); });
+        return ok;
+    }
+
+    bool run_mesh(Runner& runner, const io::ObjData& sphere) {
+        const auto faces = static_cast<double>(sphere.faces.size());
+        const auto vertices = static_cast<double>(sphere.vertices.size());
+        bool ok = true;
+
+        // the copy made in setup is what the reader would have handed over
+        io::ObjData input;
+        runner.run(
+            "mesh_triangulate", "faces", faces, [&] { input = sphere; },
+            [&] {
+                const core::Mesh mesh = make_mesh(std::move(input));
+                ok = ok && mesh.faces.size() == 2 * sphere.faces.size();
+            });
+
+        core::Mesh mesh = make_mesh(sphere);
+        const std::array<std::pair<const char*, core::NormalWeighting>, 3> weightings{{
+            {"normals_area", core::NormalWeighting::AREA},
+            {"normals_angle", core::NormalWeighting::ANGLE},
+            {"normals_uniform", core::NormalWeighting::UNIFORM},
+        }};
+        for (const auto& [name, weighting] : weightings) {
+            runner.run(name, "vertices", vertices, [&, weighting = weighting] {
+                mesh.compute_vertex_normals(weighting);
+                ok = ok && mesh.normals.size() == sphere.vertices.size();
+            });
+        }
+
+        // what every upload does before touching GL: weld the corners into one stream in the shader's vertex
+        // layout and collect the wireframe edges
+        runner.run("vertex_assembly", "vertices", vertices, [&] {
+            const graphics::AssembledMesh assembled = graphics::assemble_mesh(mesh, true);
+            ok = ok && !assembled.vertices.empty();
+        });
+        return ok;
+    }
+
+    void run_math(Runner& runner, const io::ObjData& sphere) {
+        std::mt19937 rng(42);
+        std::uniform_real_distribution<float> dist(-2.0f, 2.0f);
+        std::vector<math::Matrix4x4> matrices;
+        std::vector<math::Vector4> vectors;
+        for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+            std::array<float, 16> values{};
+            for (float& value : values) {
+                value = dist(rng);
+            }
+            matrices.emplace_back(values);
+            vectors.emplace_back(dist(rng), dist(rng), dist(rng), 1.0f);
+        }
+        std::vector<math::Matrix4x4> out(MATRIX_COUNT);
+        std::vector<math::Vector4> out_vectors(MATRIX_COUNT);
+        const auto count = static_cast<double>(MATRIX_COUNT);
+
+        runner.run("matrix_multiply", "matrices", count, [&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out[i] = matrices[i] * matrices[(i + 1) % MATRIX_COUNT];
+            }
+        });
+        runner.run("matrix_inverse", "matrices", count, [&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out[i] = matrices[i].inverse();
+            }
+        });
+        runner.run("matrix_vector", "vectors", count, [&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                out_vectors[i] = matrices[i] * vectors[i];
+            }
+        });
+
+        // a setter followed by a query, what an edited transform costs on the next frame
+        std::vector<math::Transform> transforms(MATRIX_COUNT);
+        runner.run("transform_get_matrix", "transforms", count, [&] {
+            for (std::size_t i = 0; i < MATRIX_COUNT; ++i) {
+                transforms[i].set_rotation({vectors[i].x, vectors[i].y, vectors[i].z});
+                out[i] = transforms[i].get_matrix();
+            }
+        });
+
+        std::vector<math::Vector3> points(sphere.vertices.size());
+        runner.run("batch_transform_points", "vertices", static_cast<double>(points.size()), [&] {
+            math::BatchTransforms::transform_points(matrices[0], sphere.vertices.data(), points.data(), points.size(),
+                                                    0);
+        });
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    try {
+        if (!parse_options(argc, argv, options)) {
+            std::fputs(USAGE.data(), stdout);
+            return 0;
+        }
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Bad arguments: %s\n\n%s", e.what(), USAGE.data());
+        return 2;
+    }
+
+    const io::ObjData sphere = benchmarks::make_uv_sphere(options.rings, options.rings * 2);
+    // named after the process, so runs in parallel don't read each other's file
+    const fs::path obj_path =
+        fs::temp_directory_path() / ("di_renderer_bench_pipeline_" + std::to_string(getpid()) + ".obj");
+    Runner runner(options.min_time_s, options.filter);
+    std::size_t obj_bytes = 0;
+    bool ok = true;
+    try {
+        ok = run_io(runner, sphere, obj_path, obj_bytes) && ok;
+        ok = run_mesh(runner, sphere) && ok;
+        run_math(runner, sphere);
+    } catch (const std::exception& e) {
+        std::fprintf(stderr, "Error: %s\n", e.what());
+        ok = false;
+    }
+    std::error_code ignored;
+    fs::remove(obj_path, ignored);
+
+    if (options.json.empty()) {
+        print_table(runner.results());
+    } else if (options.json == "-") {
+        write_json(stdout, runner.results(), sphere, obj_bytes);
+    } else {
+        std::FILE* file = std::fopen(options.json.c_str(), "w");
+        if (file == nullptr) {
+            std::fprintf(stderr, "Can't open file: %s\n", options.json.c_str());
+            return 1;
+        }
+        write_json(file, runner.results(), sphere, obj_bytes);
+        std::fclose(file);
+        print_table(runner.results());
+    }
+
+    if (!ok) {
+        std::puts("a stage produced a mesh that differs from the generated sphere");
+        return 1;
+    }
+    return 0;
+}
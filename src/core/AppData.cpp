@@ -2,6 +2,7 @@
 
 #include <iostream>
 #include <stdexcept>
+#include <utility>
 
 using di_renderer::core::AppData;
 using di_renderer::core::Mesh;
@@ -12,6 +13,25 @@ void AppData::clean() noexcept {
     m_current_mesh_index = 0;
     m_current_camera_index = 0;
     m_render_mode.reset();
+    notify_changed();
+}
+
+void AppData::set_change_callback(std::function<void()> callback) noexcept {
+    m_change_callback = std::move(callback);
+}
+
+void AppData::notify_changed() const noexcept {
+    if (!m_change_callback) {
+        return;
+    }
+    // runs inside noexcept setters, so a failing callback is reported rather than terminating the program
+    try {
+        m_change_callback();
+    } catch (const std::exception& e) {
+        std::cerr << "Change callback failed: " << e.what() << '\n';
+    } catch (...) {
+        std::cerr << "Change callback failed\n";
+    }
 }
 
 bool AppData::is_render_mode_enabled(RenderMode mode) const noexcept {
@@ -27,7 +47,11 @@ void AppData::disable_render_mode(const RenderMode mode) noexcept {
 }
 
 void AppData::set_render_mode(RenderMode mode, const bool value) noexcept {
+    if (m_render_mode.test(static_cast<size_t>(mode)) == value) {
+        return;
+    }
     m_render_mode.set(static_cast<size_t>(mode), value);
+    notify_changed();
 }
 
 Mesh& AppData::get_current_mesh() {
@@ -49,16 +73,19 @@ di_renderer::math::Camera& AppData::get_current_camera() noexcept {
 
 void AppData::set_current_camera(const unsigned int id) noexcept {
     m_current_camera_index = id;
+    notify_changed();
 }
 
 void AppData::delete_current_camera() noexcept {
     m_cameras.erase(m_current_camera_index);
     // the index will be updated automatically later by the UI handler
+    notify_changed();
 }
 
 void AppData::add_mesh(Mesh&& mesh) noexcept {
     m_meshes.push_back(std::move(mesh));
     m_current_mesh_index = m_meshes.size() - 1;
+    notify_changed();
 }
 
 void AppData::remove_mesh(const size_t index) {
@@ -86,6 +113,8 @@ void AppData::remove_mesh(const size_t index) {
 
     // case: deleted mesh is after selected one
     // selected mesh stays as it is
+
+    notify_changed();
 }
 
 void AppData::select_mesh(const size_t index) {
@@ -93,6 +122,7 @@ void AppData::select_mesh(const size_t index) {
         throw std::out_of_range("Mesh index out of range");
     }
     m_current_mesh_index = index;
+    notify_changed();
 }
 
 void AppData::remove_current_mesh() {
@@ -107,6 +137,14 @@ bool AppData::is_meshes_empty() const noexcept {
     return m_meshes.empty();
 }
 
+di_renderer::math::BoundingBox AppData::get_scene_bounds() const {
+    di_renderer::math::BoundingBox bounds;
+    for (const auto& mesh : m_meshes) {
+        bounds.expand(mesh.get_world_bounds());
+    }
+    return bounds;
+}
+
 bool AppData::left_button_sensitive() const noexcept {
     return m_current_mesh_index > 0;
 }
@@ -1,9 +1,11 @@
 #pragma once
 #include "Mesh.hpp"
 #include "RenderMode.hpp"
+#include "math/BoundingBox.hpp"
 #include "math/Camera.hpp"
 
 #include <bitset>
+#include <functional>
 #include <unordered_map>
 
 namespace di_renderer::core {
@@ -13,6 +15,11 @@ namespace di_renderer::core {
 
         void clean() noexcept;
 
+        // Called after every change of the mesh list, the selection, the cameras or the render modes.
+        // Edits made through the returned Mesh/Camera references are not tracked. Exceptions thrown by the
+        // callback are reported on stderr and don't reach the caller of the setter.
+        void set_change_callback(std::function<void()> callback) noexcept;
+
         bool is_render_mode_enabled(RenderMode mode) const noexcept;
         void enable_render_mode(RenderMode mode) noexcept;
         void disable_render_mode(RenderMode mode) noexcept;
@@ -27,6 +34,9 @@ namespace di_renderer::core {
         void remove_current_mesh();
         const std::vector<Mesh>& get_meshes() const noexcept;
         bool is_meshes_empty() const noexcept;
+        // World bounds of every mesh together, empty when no mesh has vertices. Built from the meshes' cached
+        // bounds, so it costs O(meshes) rather than O(vertices).
+        math::BoundingBox get_scene_bounds() const;
         bool left_button_sensitive() const noexcept;
         bool right_button_sensitive() const noexcept;
         size_t get_current_mesh_index() const noexcept;
@@ -42,5 +52,8 @@ namespace di_renderer::core {
         std::unordered_map<unsigned int, math::Camera> m_cameras;
 
         std::bitset<3> m_render_mode;
+        std::function<void()> m_change_callback;
+
+        void notify_changed() const noexcept;
     };
 } // namespace di_renderer::core
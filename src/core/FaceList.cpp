@@ -0,0 +1,109 @@
+#include "FaceList.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+namespace di_renderer::core {
+
+    FaceList::FaceList(const std::initializer_list<std::initializer_list<FaceVerticeData>> faces) {
+        std::size_t corner_count = 0;
+        for (const auto& face : faces) {
+            corner_count += face.size();
+        }
+        reserve(faces.size(), corner_count);
+        for (const auto& face : faces) {
+            push_back(face);
+        }
+    }
+
+    FaceList::FaceList(std::vector<FaceVerticeData> corners, std::vector<std::uint32_t> offsets)
+        : m_corners(std::move(corners)), m_offsets(std::move(offsets)) {
+        if (m_offsets.empty() || m_offsets.front() != 0 || m_offsets.back() != m_corners.size()) {
+            throw std::runtime_error("Bad face offsets");
+        }
+        for (std::size_t i = 1; i < m_offsets.size(); ++i) {
+            if (m_offsets[i] < m_offsets[i - 1]) {
+                throw std::runtime_error("Bad face offsets");
+            }
+            m_max_face_size = std::max<std::size_t>(m_max_face_size, m_offsets[i] - m_offsets[i - 1]);
+        }
+    }
+
+    void FaceList::reserve(const std::size_t face_count, const std::size_t corner_count) {
+        m_offsets.reserve(face_count + 1);
+        m_corners.reserve(corner_count);
+    }
+
+    void FaceList::clear() noexcept {
+        m_corners.clear();
+        m_offsets.assign(1, 0);
+        m_max_face_size = 0;
+    }
+
+    std::vector<std::uint32_t> FaceList::get_edge_indices() const {
+        // (min, max) packed into one key, so sorting groups every copy of an edge together
+        std::vector<std::uint64_t> keys;
+        keys.reserve(m_corners.size());
+        for (const auto face : *this) {
+            for (std::size_t i = 0; i < face.size(); ++i) {
+                const int from = face[i].vi;
+                const int to = face[(i + 1) % face.size()].vi;
+                if (from == to || from < 0 || to < 0) {
+                    continue;
+                }
+                const auto low = static_cast<std::uint64_t>(std::min(from, to));
+                const auto high = static_cast<std::uint64_t>(std::max(from, to));
+                keys.push_back(low << 32U | high);
+            }
+        }
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+
+        std::vector<std::uint32_t> indices;
+        indices.reserve(keys.size() * 2);
+        for (const std::uint64_t key : keys) {
+            indices.push_back(static_cast<std::uint32_t>(key >> 32U));
+            indices.push_back(static_cast<std::uint32_t>(key));
+        }
+        return indices;
+    }
+
+    void FaceList::push_back(const std::initializer_list<FaceVerticeData> face) {
+        append(face.begin(), face.end());
+    }
+
+    void FaceList::push_back(const FaceView face) {
+        append(face.begin(), face.end());
+    }
+
+    void FaceList::append(const FaceList& other) {
+        if (m_offsets.empty()) {
+            m_offsets.push_back(0);
+        }
+        check_room(other.m_corners.size());
+        const auto base = static_cast<std::uint32_t>(m_corners.size());
+        m_corners.insert(m_corners.end(), other.m_corners.begin(), other.m_corners.end());
+        m_offsets.reserve(m_offsets.size() + other.size());
+        for (std::size_t i = 1; i < other.m_offsets.size(); ++i) {
+            m_offsets.push_back(base + other.m_offsets[i]);
+        }
+        m_max_face_size = std::max(m_max_face_size, other.m_max_face_size);
+    }
+
+    void FaceList::check_room(const std::size_t corner_count) const {
+        if (corner_count > MAX_CORNER_COUNT - m_corners.size()) {
+            throw std::runtime_error("Too many face corners");
+        }
+    }
+
+    void FaceList::close_face() {
+        if (m_offsets.empty()) {
+            m_offsets.push_back(0);
+        }
+        const auto face_size = static_cast<std::size_t>(m_corners.size() - m_offsets.back());
+        m_max_face_size = std::max(m_max_face_size, face_size);
+        m_offsets.push_back(static_cast<std::uint32_t>(m_corners.size()));
+    }
+
+} // namespace di_renderer::core
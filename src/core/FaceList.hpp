@@ -0,0 +1,165 @@
+#pragma once
+
+#include "FaceVerticeData.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace di_renderer::core {
+
+    // Non-owning view of the corners of a single face stored in a FaceList
+    template <typename T> class BasicFaceView {
+      public:
+        BasicFaceView(T* corners, const std::size_t size) noexcept : m_corners(corners), m_size(size) {}
+
+        T& operator[](const std::size_t index) const noexcept {
+            return m_corners[index]; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+        std::size_t size() const noexcept {
+            return m_size;
+        }
+        bool empty() const noexcept {
+            return m_size == 0;
+        }
+
+        T* begin() const noexcept {
+            return m_corners;
+        }
+        T* end() const noexcept {
+            return m_corners + m_size; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+
+      private:
+        T* m_corners;
+        std::size_t m_size;
+    };
+
+    using FaceView = BasicFaceView<const FaceVerticeData>;
+    using MutableFaceView = BasicFaceView<FaceVerticeData>;
+
+    // Polygon faces in CSR layout: all corners in one contiguous array, face i spans
+    // corners [offsets[i], offsets[i + 1]). Replaces a vector of per-face vectors, which cost a heap
+    // allocation per face and made every traversal chase pointers.
+    class FaceList {
+      public:
+        template <typename List, typename View> class Iterator {
+          public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = View;
+            using difference_type = std::ptrdiff_t;
+            using pointer = void;
+            using reference = View;
+
+            Iterator(List* list, const std::size_t index) noexcept : m_list(list), m_index(index) {}
+
+            View operator*() const noexcept {
+                return (*m_list)[m_index];
+            }
+            Iterator& operator++() noexcept {
+                ++m_index;
+                return *this;
+            }
+            Iterator operator++(int) noexcept {
+                Iterator copy = *this;
+                ++m_index;
+                return copy;
+            }
+            bool operator==(const Iterator& other) const noexcept {
+                return m_index == other.m_index;
+            }
+            bool operator!=(const Iterator& other) const noexcept {
+                return m_index != other.m_index;
+            }
+
+          private:
+            List* m_list;
+            std::size_t m_index;
+        };
+
+        using iterator = Iterator<FaceList, MutableFaceView>;
+        using const_iterator = Iterator<const FaceList, FaceView>;
+
+        // offsets are 32-bit, appending past this many corners throws std::runtime_error
+        static constexpr std::size_t MAX_CORNER_COUNT = std::numeric_limits<std::uint32_t>::max();
+
+        FaceList() = default;
+        FaceList(std::initializer_list<std::initializer_list<FaceVerticeData>> faces);
+        // Adopts ready CSR arrays, throws std::runtime_error if offsets don't describe corners
+        FaceList(std::vector<FaceVerticeData> corners, std::vector<std::uint32_t> offsets);
+
+        std::size_t size() const noexcept {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1; // offsets are only empty after a move
+        }
+        bool empty() const noexcept {
+            return size() == 0;
+        }
+        std::size_t corner_count() const noexcept {
+            return m_corners.size();
+        }
+
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        FaceView operator[](const std::size_t index) const noexcept {
+            return {m_corners.data() + m_offsets[index], m_offsets[index + 1] - m_offsets[index]};
+        }
+        MutableFaceView operator[](const std::size_t index) noexcept {
+            return {m_corners.data() + m_offsets[index], m_offsets[index + 1] - m_offsets[index]};
+        }
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        iterator begin() noexcept {
+            return {this, 0};
+        }
+        iterator end() noexcept {
+            return {this, size()};
+        }
+        const_iterator begin() const noexcept {
+            return {this, 0};
+        }
+        const_iterator end() const noexcept {
+            return {this, size()};
+        }
+
+        // Flat access for passes that do not care about face boundaries
+        const std::vector<FaceVerticeData>& corners() const noexcept {
+            return m_corners;
+        }
+        const std::vector<std::uint32_t>& offsets() const noexcept {
+            return m_offsets;
+        }
+        // True when every face is a triangle, corners() is then a plain triangle list
+        bool is_triangle_list() const noexcept {
+            return m_corners.size() == size() * 3 && m_max_face_size <= 3;
+        }
+
+        // Vertex index pairs of every face outline edge, each undirected edge listed once in ascending order.
+        // Ready to draw as GL_LINES, so shared edges of neighbouring faces are not rasterized twice.
+        std::vector<std::uint32_t> get_edge_indices() const;
+
+        void reserve(std::size_t face_count, std::size_t corner_count);
+        void clear() noexcept;
+
+        void push_back(std::initializer_list<FaceVerticeData> face);
+        void push_back(FaceView face);
+        template <typename It> void append(It first, It last) {
+            check_room(static_cast<std::size_t>(std::distance(first, last)));
+            m_corners.insert(m_corners.end(), first, last);
+            close_face();
+        }
+        // Appends all faces of other, keeping their order
+        void append(const FaceList& other);
+
+      private:
+        std::vector<FaceVerticeData> m_corners;
+        std::vector<std::uint32_t> m_offsets{0};
+        std::size_t m_max_face_size = 0;
+
+        void check_room(std::size_t corner_count) const;
+        void close_face();
+    };
+
+} // namespace di_renderer::core
@@ -0,0 +1,148 @@
+#include "IndexedMesh.hpp"
+
+#include "FaceVerticeData.hpp"
+
+#include <algorithm>
+#include <limits>
+#include <utility>
+
+namespace di_renderer::core {
+
+    namespace {
+        constexpr std::uint32_t NO_VERTEX = std::numeric_limits<std::uint32_t>::max();
+
+        struct CornerKey {
+            int vi;
+            int ti;
+            int ni;
+
+            bool operator==(const CornerKey& other) const noexcept {
+                return vi == other.vi && ti == other.ti && ni == other.ni;
+            }
+        };
+
+        std::uint64_t hash_key(const CornerKey& key) noexcept {
+            // murmur3 finalizer over the packed triple, spreads neighbouring indices across the table
+            std::uint64_t hash = static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.vi)) << 32U |
+                                 static_cast<std::uint32_t>(key.ti);
+            hash ^= static_cast<std::uint64_t>(static_cast<std::uint32_t>(key.ni)) * 0x9E3779B97F4A7C15ULL;
+            hash ^= hash >> 33U;
+            hash *= 0xFF51AFD7ED558CCDULL;
+            hash ^= hash >> 33U;
+            hash *= 0xC4CEB9FE1A85EC53ULL;
+            hash ^= hash >> 33U;
+            return hash;
+        }
+
+        bool in_range(const int index, const std::size_t size) noexcept {
+            return index >= 0 && static_cast<std::size_t>(index) < size;
+        }
+
+        // Linear probing over vertex indices, the keys themselves live in a parallel array
+        class WeldTable {
+          public:
+            explicit WeldTable(const std::size_t max_entries) {
+                std::size_t capacity = 16;
+                while (capacity < max_entries * 2) {
+                    capacity *= 2;
+                }
+                m_slots.assign(capacity, NO_VERTEX);
+                m_keys.reserve(max_entries);
+            }
+
+            // Returns the vertex for key and whether it was just added
+            std::pair<std::uint32_t, bool> insert(const CornerKey& key) {
+                const std::size_t mask = m_slots.size() - 1;
+                for (std::size_t slot = hash_key(key) & mask;; slot = (slot + 1) & mask) {
+                    const std::uint32_t vertex = m_slots[slot];
+                    if (vertex == NO_VERTEX) {
+                        m_slots[slot] = static_cast<std::uint32_t>(m_keys.size());
+                        m_keys.push_back(key);
+                        return {m_slots[slot], true};
+                    }
+                    if (m_keys[vertex] == key) {
+                        return {vertex, false};
+                    }
+                }
+            }
+
+          private:
+            std::vector<std::uint32_t> m_slots;
+            std::vector<CornerKey> m_keys;
+        };
+    } // namespace
+
+    IndexedMesh::IndexedMesh(const Mesh& mesh) : m_position_vertices(mesh.vertices.size(), NO_VERTEX) {
+        const FaceList& faces = mesh.faces;
+        const bool has_vertex_normals = mesh.normals.size() == mesh.vertices.size();
+
+        WeldTable table(faces.corner_count());
+        std::vector<std::uint32_t> corner_vertices;
+        std::vector<std::uint32_t> indices;
+        indices.reserve(faces.corner_count() * (faces.is_triangle_list() ? 1 : 3));
+        m_vertices.reserve(mesh.vertices.size());
+
+        for (const auto face : faces) {
+            if (face.size() < 3 || !std::all_of(face.begin(), face.end(), [&](const FaceVerticeData& corner) {
+                    return in_range(corner.vi, mesh.vertices.size());
+                })) {
+                continue;
+            }
+
+            corner_vertices.clear();
+            for (const auto& corner : face) {
+                // resolve first, corners that end up with identical attributes share a vertex
+                const int ti = in_range(corner.ti, mesh.texture_vertices.size()) ? corner.ti : -1;
+                int ni = -1;
+                if (in_range(corner.ni, mesh.normals.size())) {
+                    ni = corner.ni;
+                } else if (has_vertex_normals) {
+                    ni = corner.vi;
+                }
+
+                const auto [vertex, inserted] = table.insert({corner.vi, ti, ni});
+                if (inserted) {
+                    m_vertices.push_back({mesh.vertices[corner.vi],
+                                          ti >= 0 ? mesh.texture_vertices[ti] : math::UVCoord(0.0f, 0.0f),
+                                          ni >= 0 ? mesh.normals[ni] : math::Vector3(0.0f, 1.0f, 0.0f)});
+                }
+                m_position_vertices[corner.vi] = vertex;
+                corner_vertices.push_back(vertex);
+            }
+
+            for (std::size_t i = 2; i < corner_vertices.size(); ++i) {
+                indices.push_back(corner_vertices[0]);
+                indices.push_back(corner_vertices[i - 1]);
+                indices.push_back(corner_vertices[i]);
+            }
+        }
+
+        if (m_vertices.size() <= static_cast<std::size_t>(std::numeric_limits<std::uint16_t>::max()) + 1) {
+            m_indices16.resize(indices.size());
+            std::transform(indices.begin(), indices.end(), m_indices16.begin(),
+                           [](const std::uint32_t index) { return static_cast<std::uint16_t>(index); });
+        } else {
+            m_indices32 = std::move(indices);
+        }
+    }
+
+    std::vector<std::uint32_t> IndexedMesh::get_edge_indices(const FaceList& faces) const {
+        std::vector<std::uint32_t> edges = faces.get_edge_indices();
+        std::size_t kept = 0;
+        for (std::size_t i = 0; i + 1 < edges.size(); i += 2) {
+            if (edges[i] >= m_position_vertices.size() || edges[i + 1] >= m_position_vertices.size()) {
+                continue;
+            }
+            const std::uint32_t from = m_position_vertices[edges[i]];
+            const std::uint32_t to = m_position_vertices[edges[i + 1]];
+            if (from == NO_VERTEX || to == NO_VERTEX) {
+                continue;
+            }
+            edges[kept++] = from;
+            edges[kept++] = to;
+        }
+        edges.resize(kept);
+        return edges;
+    }
+
+} // namespace di_renderer::core
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "FaceList.hpp"
+#include "Mesh.hpp"
+#include "math/UVCoord.hpp"
+#include "math/Vector3.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace di_renderer::core {
+
+    struct IndexedVertex {
+        math::Vector3 position;
+        math::UVCoord uv;
+        math::Vector3 normal;
+    };
+
+    // Single indexed vertex stream for GPU upload: every unique (vi, ti, ni) corner of a mesh becomes one vertex,
+    // so UV and normal seams are kept while shared corners are stored once. Polygons are fan-triangulated and
+    // faces referencing a missing position are dropped.
+    //
+    // Missing UVs resolve to (0, 0); missing normals fall back to normals[vi] (what compute_vertex_normals()
+    // produces) and then to +Y. Corners are welded after that resolution, so they never split vertices needlessly.
+    class IndexedMesh {
+      public:
+        // Linear in the number of corners, welding goes through an open-addressing hash table
+        explicit IndexedMesh(const Mesh& mesh);
+
+        const std::vector<IndexedVertex>& vertices() const noexcept {
+            return m_vertices;
+        }
+
+        // Triangle list over vertices(). Stored as 16-bit when every index fits, exactly one of the two
+        // arrays is filled then.
+        bool has_16bit_indices() const noexcept {
+            return m_indices32.empty() && !m_indices16.empty();
+        }
+        const std::vector<std::uint16_t>& indices16() const noexcept {
+            return m_indices16;
+        }
+        const std::vector<std::uint32_t>& indices32() const noexcept {
+            return m_indices32;
+        }
+        std::size_t index_count() const noexcept {
+            return m_indices16.size() + m_indices32.size();
+        }
+
+        // FaceList::get_edge_indices() of faces, remapped onto vertices(). Seams do not duplicate an edge,
+        // it uses one of the welded vertices at each end.
+        std::vector<std::uint32_t> get_edge_indices(const FaceList& faces) const;
+
+      private:
+        std::vector<IndexedVertex> m_vertices;
+        std::vector<std::uint16_t> m_indices16;
+        std::vector<std::uint32_t> m_indices32;
+        // a welded vertex for each position index, NO_VERTEX when no face uses it
+        std::vector<std::uint32_t> m_position_vertices;
+    };
+
+} // namespace di_renderer::core
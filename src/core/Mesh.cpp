@@ -1,37 +1,118 @@
 #include "Mesh.hpp"
 
+#include "jobs/JobSystem.hpp"
+#include "math/Simd.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
 #include <cmath>
 #include <limits>
+#include <numeric>
+#include <stdexcept>
 #include <string_view>
 
 namespace di_renderer::core {
+    namespace {
+        constexpr std::size_t MIN_NORMALS_CHUNK_SIZE = std::size_t{1} << 15U;
+        constexpr std::size_t MIN_TRIANGULATION_CHUNK_SIZE = std::size_t{1} << 15U;
+
+        // Normalizes every vector longer than epsilon and leaves the others untouched. Computes x / sqrt(x*x + y*y
+        // + z*z) in the same order as Vector3::normalized(), so both paths give identical results.
+        void normalize_normals(math::Vector3* normals, const std::size_t count) {
+            constexpr float EPSILON = std::numeric_limits<float>::epsilon();
+            std::size_t i = 0;
+            // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+#ifdef DI_RENDERER_SSE
+            const __m128 epsilon = _mm_set1_ps(EPSILON);
+            for (; i + 4 <= count; i += 4) {
+                math::Vector3* n = normals + i;
+                const __m128 x = _mm_setr_ps(n[0].x, n[1].x, n[2].x, n[3].x);
+                const __m128 y = _mm_setr_ps(n[0].y, n[1].y, n[2].y, n[3].y);
+                const __m128 z = _mm_setr_ps(n[0].z, n[1].z, n[2].z, n[3].z);
+                const __m128 length = _mm_sqrt_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y)), _mm_mul_ps(z, z)));
+                const __m128 keep = _mm_cmple_ps(length, epsilon);
+                const auto select = [&](const __m128 value) {
+                    return _mm_or_ps(_mm_and_ps(keep, value), _mm_andnot_ps(keep, _mm_div_ps(value, length)));
+                };
+
+                std::array<float, 4> out_x{};
+                std::array<float, 4> out_y{};
+                std::array<float, 4> out_z{};
+                _mm_storeu_ps(out_x.data(), select(x));
+                _mm_storeu_ps(out_y.data(), select(y));
+                _mm_storeu_ps(out_z.data(), select(z));
+                for (std::size_t k = 0; k < 4; ++k) {
+                    n[k] = {out_x.at(k), out_y.at(k), out_z.at(k)};
+                }
+            }
+#endif
+            for (; i < count; ++i) {
+                const float length = normals[i].length();
+                if (length > EPSILON) {
+                    normals[i] = {normals[i].x / length, normals[i].y / length, normals[i].z / length};
+                }
+            }
+            // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+        }
+    } // namespace
 
     Mesh::Mesh(std::vector<math::Vector3> vertices, std::vector<math::UVCoord> texture_vertices,
-               std::vector<math::Vector3> normals, const std::vector<std::vector<FaceVerticeData>>& faces) noexcept
+               std::vector<math::Vector3> normals, Faces faces)
         : vertices(std::move(vertices)), texture_vertices(std::move(texture_vertices)), normals(std::move(normals)) {
-        triangulate_faces(faces);
+        triangulate_faces(std::move(faces));
         if (this->normals.empty()) {
             compute_vertex_normals();
         }
+        // done here so loading, usually off the main thread, pays for it rather than the first frame
+        get_local_bounds();
     }
 
-    void Mesh::triangulate_faces(const std::vector<std::vector<FaceVerticeData>>& input_faces) noexcept {
-        faces.clear();
-        faces.reserve(input_faces.size() * 2);
+    void Mesh::triangulate_faces(Faces input_faces) {
+        // the common case of an all-triangle model keeps the reader's storage as is
+        if (input_faces.is_triangle_list()) {
+            faces = std::move(input_faces);
+            return;
+        }
 
-        for (const auto& face : input_faces) {
-            if (face.size() < 3) {
-                continue;
+        // fan triangulation in two passes over the same ranges: count the triangles of each range, then write
+        // every range at the offset the counts before it add up to
+        auto& system = jobs::JobSystem::global();
+        const Faces& source = input_faces;
+        const std::size_t chunk_count = system.get_chunk_count(source.size(), MIN_TRIANGULATION_CHUNK_SIZE);
+        std::vector<std::size_t> chunk_offsets(chunk_count + 1, 0);
+        system.parallel_for_each(chunk_count, [&](const std::size_t chunk) {
+            const auto [begin, end] = jobs::JobSystem::get_chunk_bounds(source.size(), chunk_count, chunk);
+            std::size_t triangle_count = 0;
+            for (std::size_t f = begin; f < end; ++f) {
+                const std::size_t size = source[f].size();
+                triangle_count += size >= 3 ? size - 2 : 0;
             }
+            chunk_offsets[chunk + 1] = triangle_count;
+        });
+        std::partial_sum(chunk_offsets.begin(), chunk_offsets.end(), chunk_offsets.begin());
 
-            if (face.size() == 3) {
-                faces.push_back(face);
-            } else if (face.size() > 3) {
-                for (size_t i = 1; i < face.size() - 1; ++i) {
-                    faces.push_back({face[0], face[i], face[i + 1]});
+        const std::size_t triangle_count = chunk_offsets.back();
+        if (triangle_count > FaceList::MAX_CORNER_COUNT / 3) {
+            throw std::runtime_error("Too many face corners");
+        }
+        std::vector<FaceVerticeData> corners(triangle_count * 3);
+        std::vector<std::uint32_t> offsets(triangle_count + 1);
+        system.parallel_for_each(chunk_count, [&](const std::size_t chunk) {
+            const auto [begin, end] = jobs::JobSystem::get_chunk_bounds(source.size(), chunk_count, chunk);
+            std::size_t triangle = chunk_offsets[chunk];
+            for (std::size_t f = begin; f < end; ++f) {
+                const FaceView face = source[f];
+                for (std::size_t i = 1; i + 1 < face.size(); ++i, ++triangle) {
+                    corners[triangle * 3] = face[0];
+                    corners[(triangle * 3) + 1] = face[i];
+                    corners[(triangle * 3) + 2] = face[i + 1];
+                    offsets[triangle + 1] = static_cast<std::uint32_t>((triangle + 1) * 3);
                 }
             }
-        }
+        });
+        faces = Faces(std::move(corners), std::move(offsets));
     }
 
     void Mesh::load_texture(std::string_view filename) {
@@ -42,50 +123,121 @@ namespace di_renderer::core {
         return texture_filename;
     }
 
-    void Mesh::compute_vertex_normals() {
+    void Mesh::compute_vertex_normals(const NormalWeighting weighting) {
         normals.assign(vertices.size(), math::Vector3(0.0f, 0.0f, 0.0f));
 
         if (vertices.empty() || faces.empty()) {
             return;
         }
 
-        for (const auto& face : faces) {
-            if (face.size() < 3) {
-                continue;
+        // Vertex -> face corner adjacency in CSR form, each list in face order. Gathering over it lets threads own
+        // disjoint vertex ranges, and adds every vertex's contributions in the same order as a serial scatter.
+        // Only the first three corners of a face contribute, as for a triangle.
+        const FaceList& face_list = faces;
+        const std::size_t vertex_count = vertices.size();
+        const auto face_is_valid = [&](const FaceView face) {
+            return face.size() >= 3 && std::all_of(face.begin(), face.begin() + 3, [&](const FaceVerticeData& c) {
+                       return c.vi >= 0 && static_cast<std::size_t>(c.vi) < vertex_count;
+                   });
+        };
+
+        // adjacency entries are face * 3 + corner, and no offset exceeds their count
+        if (face_list.size() > std::numeric_limits<std::uint32_t>::max() / 3) {
+            throw std::runtime_error("Too many faces to compute vertex normals");
+        }
+        std::vector<std::uint32_t> adjacency_offsets(vertex_count + 1, 0);
+        for (const FaceView face : face_list) {
+            if (face_is_valid(face)) {
+                for (std::size_t k = 0; k < 3; ++k) {
+                    ++adjacency_offsets[static_cast<std::size_t>(face[k].vi) + 1];
+                }
             }
-
-            const int v0_idx = face[0].vi;
-            const int v1_idx = face[1].vi;
-            const int v2_idx = face[2].vi;
-
-            const std::size_t vs = vertices.size();
-            if (v0_idx < 0 || v1_idx < 0 || v2_idx < 0 || static_cast<std::size_t>(v0_idx) >= vs ||
-                static_cast<std::size_t>(v1_idx) >= vs || static_cast<std::size_t>(v2_idx) >= vs) {
-                continue;
+        }
+        std::partial_sum(adjacency_offsets.begin(), adjacency_offsets.end(), adjacency_offsets.begin());
+
+        std::vector<std::uint32_t> adjacency(adjacency_offsets.back());
+        {
+            std::vector<std::uint32_t> cursor(adjacency_offsets.begin(), adjacency_offsets.end() - 1);
+            for (std::size_t f = 0; f < face_list.size(); ++f) {
+                const FaceView face = face_list[f];
+                if (face_is_valid(face)) {
+                    for (std::size_t k = 0; k < 3; ++k) {
+                        adjacency[cursor[static_cast<std::size_t>(face[k].vi)]++] =
+                            static_cast<std::uint32_t>((f * 3) + k);
+                    }
+                }
             }
-            const math::Vector3& v0 = vertices[v0_idx];
-            const math::Vector3& v1 = vertices[v1_idx];
-            const math::Vector3& v2 = vertices[v2_idx];
+        }
 
+        const auto contribution = [&](const std::uint32_t entry) {
+            const FaceView face = face_list[entry / 3];
+            const math::Vector3& v0 = vertices[face[0].vi];
+            const math::Vector3& v1 = vertices[face[1].vi];
+            const math::Vector3& v2 = vertices[face[2].vi];
             const math::Vector3 edge1 = v1 - v0;
             const math::Vector3 edge2 = v2 - v0;
+            // twice the area, so AREA is simply the unnormalized cross product
             const math::Vector3 face_normal = edge1.cross(edge2);
+            if (weighting == NormalWeighting::AREA) {
+                return face_normal;
+            }
 
-            normals[v0_idx] = normals[v0_idx] + face_normal;
-            normals[v1_idx] = normals[v1_idx] + face_normal;
-            normals[v2_idx] = normals[v2_idx] + face_normal;
-        }
-
-        for (auto& normal : normals) {
-            const float length = normal.length();
-            if (length > std::numeric_limits<float>::epsilon()) {
-                normal = normal.normalized();
+            const math::Vector3 unit_normal = face_normal.normalized();
+            if (weighting == NormalWeighting::UNIFORM) {
+                return unit_normal;
             }
-        }
+            const std::array<const math::Vector3*, 3> corner = {&v0, &v1, &v2};
+            const std::size_t k = entry % 3;
+            const math::Vector3 to_next = (*corner.at((k + 1) % 3) - *corner.at(k)).normalized();
+            const math::Vector3 to_prev = (*corner.at((k + 2) % 3) - *corner.at(k)).normalized();
+            return unit_normal * std::acos(std::clamp(to_next.dot(to_prev), -1.0f, 1.0f));
+        };
+
+        jobs::JobSystem::global().parallel_for(vertex_count, MIN_NORMALS_CHUNK_SIZE, [&](const std::size_t begin,
+                                                                                         const std::size_t end) {
+            for (std::size_t v = begin; v < end; ++v) {
+                math::Vector3 sum = normals[v];
+                for (std::uint32_t i = adjacency_offsets[v]; i < adjacency_offsets[v + 1]; ++i) {
+                    sum = sum + contribution(adjacency[i]);
+                }
+                normals[v] = sum;
+            }
+            normalize_normals(normals.data() + begin, end - begin); // NOLINT(*-pointer-arithmetic)
+        });
+        mark_geometry_dirty();
     }
 
     math::Transform& Mesh::get_transform() noexcept {
         return m_transform;
     }
 
+    const math::Transform& Mesh::get_transform() const noexcept {
+        return m_transform;
+    }
+
+    std::uint64_t Mesh::get_geometry_revision() const noexcept {
+        return m_geometry_revision;
+    }
+
+    void Mesh::mark_geometry_dirty() noexcept {
+        m_geometry_revision = next_geometry_revision();
+    }
+
+    const math::BoundingBox& Mesh::get_local_bounds() const {
+        if (m_local_bounds_revision != m_geometry_revision) {
+            m_local_bounds = math::BoundingBox::from_points(vertices.data(), vertices.size());
+            m_local_bounds_revision = m_geometry_revision;
+        }
+        return m_local_bounds;
+    }
+
+    math::BoundingBox Mesh::get_world_bounds() const {
+        return get_local_bounds().transformed(m_transform.get_matrix());
+    }
+
+    std::uint64_t Mesh::next_geometry_revision() noexcept {
+        static std::atomic<std::uint64_t> next_revision{1};
+        return next_revision.fetch_add(1, std::memory_order_relaxed);
+    }
+
 } // namespace di_renderer::core
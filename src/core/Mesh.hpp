@@ -1,20 +1,30 @@
 #pragma once
 
+#include "FaceList.hpp"
 #include "FaceVerticeData.hpp"
+#include "math/BoundingBox.hpp"
 #include "math/Transform.hpp"
 #include "math/UVCoord.hpp"
 #include "math/Vector3.hpp"
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <vector>
 
 namespace di_renderer::core {
 
+    // How face normals are weighted when averaged into vertex normals
+    enum class NormalWeighting : std::uint8_t {
+        AREA = 0,    // by face area, favours large faces
+        ANGLE = 1,   // by the face's interior angle at the vertex, independent of how the surface is tessellated
+        UNIFORM = 2, // every adjacent face counts the same
+    };
+
     class Mesh {
       public:
-        using Faces = std::vector<std::vector<FaceVerticeData>>;
+        using Faces = FaceList;
 
         std::vector<math::Vector3> vertices;
         std::vector<math::UVCoord> texture_vertices;
@@ -25,7 +35,7 @@ namespace di_renderer::core {
 
         Mesh() = default;
         Mesh(std::vector<math::Vector3> vertices, std::vector<math::UVCoord> texture_vertices,
-             std::vector<math::Vector3> normals, const std::vector<std::vector<FaceVerticeData>>& faces) noexcept;
+             std::vector<math::Vector3> normals, Faces faces);
 
         std::size_t vertex_count() const noexcept {
             return vertices.size();
@@ -43,14 +53,33 @@ namespace di_renderer::core {
         void load_texture(std::string_view filename);
         const std::string& get_texture_filename() const noexcept;
 
-        void compute_vertex_normals();
+        // Replaces normals with one normal per position, computed in parallel for large meshes
+        void compute_vertex_normals(NormalWeighting weighting = NormalWeighting::AREA);
 
         math::Transform& get_transform() noexcept;
+        const math::Transform& get_transform() const noexcept;
+
+        // Identifies the current contents of vertices/texture_vertices/normals/faces. Copies share it, any
+        // geometry edit must call mark_geometry_dirty() so that GPU-side copies get re-uploaded.
+        std::uint64_t get_geometry_revision() const noexcept;
+        void mark_geometry_dirty() noexcept;
+
+        // Model-space bounds of the vertices. Computed on construction and again on the first query after
+        // mark_geometry_dirty(), so it is as current as the geometry revision.
+        const math::BoundingBox& get_local_bounds() const;
+        // Local bounds moved through the transform: encloses every transformed vertex, costs O(1) per call
+        math::BoundingBox get_world_bounds() const;
 
       private:
         math::Transform m_transform;
+        std::uint64_t m_geometry_revision = next_geometry_revision();
+        mutable math::BoundingBox m_local_bounds;
+        // geometry revision m_local_bounds was computed for, 0 = never
+        mutable std::uint64_t m_local_bounds_revision = 0;
+
+        static std::uint64_t next_geometry_revision() noexcept;
 
-        void triangulate_faces(const std::vector<std::vector<FaceVerticeData>>& input_faces) noexcept;
+        void triangulate_faces(Faces input_faces);
     };
 
 } // namespace di_renderer::core
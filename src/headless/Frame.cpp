@@ -0,0 +1,11 @@
+#include "Frame.hpp"
+
+namespace di_renderer::headless {
+    void prepare_camera(math::Camera& camera, const int width, const int height,
+                        const math::BoundingBox& scene_bounds) {
+        camera.set_aspect_ratio(static_cast<float>(width) / static_cast<float>(height));
+        if (!scene_bounds.is_empty()) {
+            camera.fit_planes_to_bounds(scene_bounds, (camera.get_position() - camera.get_target()).length());
+        }
+    }
+} // namespace di_renderer::headless
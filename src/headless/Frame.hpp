@@ -0,0 +1,22 @@
+#pragma once
+
+#include "math/BoundingBox.hpp"
+#include "math/Camera.hpp"
+#include "math/Vector3.hpp"
+
+#include <cstddef>
+
+namespace di_renderer::headless {
+    // background of the GTK viewport
+    inline constexpr math::Vector3 CLEAR_COLOR{0.1f, 0.2f, 0.3f};
+
+    struct FrameStats {
+        double cpu_ms = 0.0;  // from the start of the frame until it was complete
+        double gpu_ms = -1.0; // GL_TIME_ELAPSED of the frame, -1 without a GPU timer
+        std::size_t drawn = 0;
+        std::size_t culled = 0;
+    };
+
+    // Sets the camera's aspect ratio to the image and fits its clip planes to the scene like the viewport does
+    void prepare_camera(math::Camera& camera, int width, int height, const math::BoundingBox& scene_bounds);
+} // namespace di_renderer::headless
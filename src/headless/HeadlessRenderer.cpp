@@ -0,0 +1,138 @@
+#include "HeadlessRenderer.hpp"
+
+#include "math/Frustum.hpp"
+
+#include <chrono>
+#include <stdexcept>
+#include <utility>
+
+namespace di_renderer::headless {
+    namespace {
+        // Timer queries are core in 3.3, but software drivers may still report zero counter bits
+        bool has_timer_queries() {
+            GLint bits = 0;
+            glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+            return bits > 0;
+        }
+    } // namespace
+
+    HeadlessRenderer::HeadlessRenderer(const int width, const int height) : m_context(width, height) {
+        m_gl_state.invalidate();
+        m_shader_program = graphics::create_shader_program();
+        if (!m_shader_program.valid()) {
+            throw std::runtime_error("Failed to create the shader program");
+        }
+        if (has_timer_queries()) {
+            glGenQueries(1, &m_timer_query);
+            // llvmpipe reports a bogus time for the first query of a context, a clear is timed once and dropped
+            GLuint64 elapsed_ns = 0;
+            glBeginQuery(GL_TIME_ELAPSED, m_timer_query);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glEndQuery(GL_TIME_ELAPSED);
+            glGetQueryObjectui64v(m_timer_query, GL_QUERY_RESULT, &elapsed_ns);
+        }
+    }
+
+    HeadlessRenderer::~HeadlessRenderer() {
+        m_gl_state.use_program(0);
+        m_gl_state.bind_vertex_array(0);
+        for (auto& buffer : m_mesh_buffers) {
+            buffer.destroy();
+        }
+        if (m_timer_query != 0) {
+            glDeleteQueries(1, &m_timer_query);
+        }
+        graphics::destroy_shader_program(m_shader_program);
+    }
+
+    void HeadlessRenderer::add_mesh(core::Mesh&& mesh) {
+        // same vertex layout as the viewport, v flipped for textures stored top row first
+        graphics::upload_mesh(m_gl_state, m_mesh_buffers.emplace_back(), mesh, true);
+        m_meshes.push_back(std::move(mesh));
+    }
+
+    math::BoundingBox HeadlessRenderer::get_scene_bounds() const {
+        math::BoundingBox bounds;
+        for (const auto& mesh : m_meshes) {
+            bounds.expand(mesh.get_world_bounds());
+        }
+        return bounds;
+    }
+
+    FrameStats HeadlessRenderer::render(math::Camera& camera) {
+        using Clock = std::chrono::steady_clock;
+        FrameStats stats;
+
+        const auto start = Clock::now();
+        if (m_timer_query != 0) {
+            glBeginQuery(GL_TIME_ELAPSED, m_timer_query);
+        }
+
+        prepare_camera(camera, m_context.get_width(), m_context.get_height(), get_scene_bounds());
+
+        m_gl_state.depth_mask(GL_TRUE);
+        glClearColor(CLEAR_COLOR.x, CLEAR_COLOR.y, CLEAR_COLOR.z, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+        m_gl_state.set_enabled(GL_DEPTH_TEST, true);
+        m_gl_state.depth_func(GL_LESS);
+        m_gl_state.set_enabled(GL_CULL_FACE, true);
+        m_gl_state.cull_face(GL_BACK);
+        m_gl_state.front_face(GL_CCW);
+
+        set_default_uniforms(camera);
+
+        const math::Frustum frustum(camera.get_view_projection_matrix());
+        for (std::size_t i = 0; i < m_meshes.size(); ++i) {
+            const math::BoundingBox bounds = m_meshes[i].get_world_bounds();
+            if (m_mesh_buffers[i].empty() || !frustum.intersects(bounds)) {
+                ++stats.culled;
+                continue;
+            }
+            graphics::set_model_uniforms(m_shader_program.uniforms(), m_meshes[i].get_transform());
+            m_mesh_buffers[i].draw(m_gl_state);
+            ++stats.drawn;
+        }
+
+        if (m_timer_query != 0) {
+            glEndQuery(GL_TIME_ELAPSED);
+        }
+        glFinish();
+        stats.cpu_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+        if (m_timer_query != 0) {
+            GLuint64 elapsed_ns = 0;
+            glGetQueryObjectui64v(m_timer_query, GL_QUERY_RESULT, &elapsed_ns);
+            stats.gpu_ms = static_cast<double>(elapsed_ns) / 1.0e6;
+        }
+        return stats;
+    }
+
+    std::vector<std::uint8_t> HeadlessRenderer::read_pixels() const {
+        return m_context.read_pixels();
+    }
+
+    void HeadlessRenderer::set_default_uniforms(const math::Camera& camera) {
+        m_gl_state.use_program(m_shader_program.id());
+
+        const auto& uniforms = m_shader_program.uniforms();
+        graphics::set_camera_uniforms(uniforms, camera);
+        if (uniforms.light_color1 != -1) {
+            glUniform3f(uniforms.light_color1, 1.0f, 1.0f, 1.0f);
+        }
+        if (uniforms.use_light2 != -1) {
+            glUniform1i(uniforms.use_light2, 0);
+        }
+        if (uniforms.use_texture != -1) {
+            glUniform1i(uniforms.use_texture, 0);
+        }
+        if (uniforms.texture != -1) {
+            glUniform1i(uniforms.texture, 0);
+        }
+        if (uniforms.tint != -1) {
+            glUniform3f(uniforms.tint, 1.0f, 1.0f, 1.0f);
+        }
+        m_gl_state.active_texture(GL_TEXTURE0);
+        m_gl_state.bind_texture_2d(0);
+    }
+} // namespace di_renderer::headless
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Frame.hpp"
+#include "OffscreenContext.hpp"
+#include "core/Mesh.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/Camera.hpp"
+#include "render/GLState.hpp"
+#include "render/Triangle.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace di_renderer::headless {
+    // Draws meshes into an OffscreenContext with the same shader, buffers and GL state as the GTK viewport's
+    // default render mode. Textures are not drawn, the texture loader depends on GDK.
+    class HeadlessRenderer final {
+      public:
+        // Throws std::runtime_error when the context or the shader can't be created
+        HeadlessRenderer(int width, int height);
+        ~HeadlessRenderer();
+        HeadlessRenderer(const HeadlessRenderer&) = delete;
+        HeadlessRenderer& operator=(const HeadlessRenderer&) = delete;
+        HeadlessRenderer(HeadlessRenderer&&) = delete;
+        HeadlessRenderer& operator=(HeadlessRenderer&&) = delete;
+
+        // Uploads the mesh right away, the renderer keeps it for all following frames
+        void add_mesh(core::Mesh&& mesh);
+        math::BoundingBox get_scene_bounds() const;
+
+        // Prepares the camera for the framebuffer and the scene (see prepare_camera), then draws one frame
+        FrameStats render(math::Camera& camera);
+        // RGB8 rows of the last frame, top row first
+        std::vector<std::uint8_t> read_pixels() const;
+
+        const OffscreenContext& get_context() const noexcept {
+            return m_context;
+        }
+
+      private:
+        // declared first so it is destroyed last, every GL name below must go while it is current
+        OffscreenContext m_context;
+        graphics::GLState m_gl_state;
+        graphics::ShaderProgram m_shader_program;
+        std::vector<core::Mesh> m_meshes;
+        std::vector<graphics::MeshBuffer> m_mesh_buffers;
+        GLuint m_timer_query = 0;
+
+        void set_default_uniforms(const math::Camera& camera);
+    };
+} // namespace di_renderer::headless
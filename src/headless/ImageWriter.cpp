@@ -0,0 +1,25 @@
+#include "ImageWriter.hpp"
+
+#include <fstream>
+#include <stdexcept>
+
+namespace di_renderer::headless {
+    void write_ppm(const std::string& filename, const int width, const int height,
+                   const std::vector<std::uint8_t>& pixels) {
+        if (width <= 0 || height <= 0 ||
+            pixels.size() != static_cast<std::size_t>(width) * static_cast<std::size_t>(height) * 3) {
+            throw std::runtime_error("Pixel data does not match the image size");
+        }
+
+        std::ofstream file(filename, std::ios::binary);
+        if (!file) {
+            throw std::runtime_error("Can't open file: " + filename);
+        }
+        file << "P6\n" << width << ' ' << height << "\n255\n";
+        file.write(reinterpret_cast<const char*>(pixels.data()), // NOLINT(*-reinterpret-cast)
+                   static_cast<std::streamsize>(pixels.size()));
+        if (!file) {
+            throw std::runtime_error("Failed to write file: " + filename);
+        }
+    }
+} // namespace di_renderer::headless
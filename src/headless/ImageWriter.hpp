@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace di_renderer::headless {
+    // Binary PPM (P6), readable by most image tools and trivial to diff byte for byte in regression tests.
+    // Expects tightly packed RGB8 rows, top row first. Throws std::runtime_error on I/O errors.
+    void write_ppm(const std::string& filename, int width, int height, const std::vector<std::uint8_t>& pixels);
+} // namespace di_renderer::headless
@@ -0,0 +1,167 @@
+#include "OffscreenContext.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+
+namespace di_renderer::headless {
+    namespace {
+        // extension strings are space separated names, a plain substring search would match prefixes
+        bool has_extension(const char* extensions, const std::string_view name) {
+            std::string_view rest = extensions == nullptr ? std::string_view{} : std::string_view{extensions};
+            while (!rest.empty()) {
+                const std::size_t end = std::min(rest.find(' '), rest.size());
+                if (rest.substr(0, end) == name) {
+                    return true;
+                }
+                rest.remove_prefix(std::min(end + 1, rest.size()));
+            }
+            return false;
+        }
+
+        EGLDisplay get_display() {
+            // client extensions, queried without a display
+            const char* client_extensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+            if (has_extension(client_extensions, "EGL_MESA_platform_surfaceless")) {
+                const EGLDisplay display = eglGetPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY,
+                                                                 nullptr);
+                if (display != EGL_NO_DISPLAY) {
+                    return display;
+                }
+            }
+            return eglGetDisplay(EGL_DEFAULT_DISPLAY);
+        }
+    } // namespace
+
+    OffscreenContext::OffscreenContext(const int width, const int height) : m_width(width), m_height(height) {
+        if (width <= 0 || height <= 0) {
+            throw std::runtime_error("Bad offscreen framebuffer size");
+        }
+        try {
+            create_context();
+            create_framebuffer();
+        } catch (...) {
+            destroy();
+            throw;
+        }
+    }
+
+    OffscreenContext::~OffscreenContext() {
+        destroy();
+    }
+
+    void OffscreenContext::create_context() {
+        m_display = get_display();
+        if (m_display == EGL_NO_DISPLAY || eglInitialize(m_display, nullptr, nullptr) == EGL_FALSE) {
+            m_display = EGL_NO_DISPLAY;
+            throw std::runtime_error("Could not initialize an EGL display");
+        }
+        if (eglBindAPI(EGL_OPENGL_API) == EGL_FALSE) {
+            throw std::runtime_error("EGL display does not support desktop OpenGL");
+        }
+
+        const bool surfaceless =
+            has_extension(eglQueryString(m_display, EGL_EXTENSIONS), "EGL_KHR_surfaceless_context");
+        const std::array<EGLint, 5> config_attributes = {EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT, EGL_SURFACE_TYPE,
+                                                         surfaceless ? 0 : EGL_PBUFFER_BIT, EGL_NONE};
+        EGLConfig config = nullptr;
+        EGLint config_count = 0;
+        if (eglChooseConfig(m_display, config_attributes.data(), &config, 1, &config_count) == EGL_FALSE ||
+            config_count == 0) {
+            throw std::runtime_error("No EGL config for desktop OpenGL");
+        }
+
+        const std::array<EGLint, 7> context_attributes = {EGL_CONTEXT_MAJOR_VERSION,
+                                                          3,
+                                                          EGL_CONTEXT_MINOR_VERSION,
+                                                          3,
+                                                          EGL_CONTEXT_OPENGL_PROFILE_MASK,
+                                                          EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+                                                          EGL_NONE};
+        m_context = eglCreateContext(m_display, config, EGL_NO_CONTEXT, context_attributes.data());
+        if (m_context == EGL_NO_CONTEXT) {
+            throw std::runtime_error("Could not create an OpenGL 3.3 core context");
+        }
+
+        if (!surfaceless) {
+            // the framebuffer object is what gets drawn to, the pbuffer only has to exist
+            const std::array<EGLint, 5> pbuffer_attributes = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+            m_surface = eglCreatePbufferSurface(m_display, config, pbuffer_attributes.data());
+            if (m_surface == EGL_NO_SURFACE) {
+                throw std::runtime_error("Could not create an EGL pbuffer");
+            }
+        }
+        if (eglMakeCurrent(m_display, m_surface, m_surface, m_context) == EGL_FALSE) {
+            throw std::runtime_error("Could not make the offscreen context current");
+        }
+    }
+
+    void OffscreenContext::create_framebuffer() {
+        glGenRenderbuffers(1, &m_color_buffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_color_buffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, m_width, m_height);
+        glGenRenderbuffers(1, &m_depth_buffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, m_depth_buffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, m_width, m_height);
+        glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+        glGenFramebuffers(1, &m_framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_color_buffer);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, m_depth_buffer);
+        if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+            throw std::runtime_error("Offscreen framebuffer is incomplete");
+        }
+        glViewport(0, 0, m_width, m_height);
+    }
+
+    std::string OffscreenContext::get_renderer_name() const {
+        const auto* name = reinterpret_cast<const char*>(glGetString(GL_RENDERER)); // NOLINT(*-reinterpret-cast)
+        return name == nullptr ? std::string{} : std::string{name};
+    }
+
+    std::vector<std::uint8_t> OffscreenContext::read_pixels() const {
+        const auto row_size = static_cast<std::size_t>(m_width) * 3;
+        std::vector<std::uint8_t> pixels(row_size * static_cast<std::size_t>(m_height));
+        glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, m_width, m_height, GL_RGB, GL_UNSIGNED_BYTE, pixels.data());
+
+        // GL rows start at the bottom
+        std::vector<std::uint8_t> row(row_size);
+        for (std::size_t top = 0, bottom = static_cast<std::size_t>(m_height) - 1; top < bottom; ++top, --bottom) {
+            std::memcpy(row.data(), &pixels[top * row_size], row_size);
+            std::memcpy(&pixels[top * row_size], &pixels[bottom * row_size], row_size);
+            std::memcpy(&pixels[bottom * row_size], row.data(), row_size);
+        }
+        return pixels;
+    }
+
+    void OffscreenContext::destroy() noexcept {
+        if (m_context != EGL_NO_CONTEXT) {
+            if (m_framebuffer != 0) {
+                glDeleteFramebuffers(1, &m_framebuffer);
+            }
+            if (m_color_buffer != 0) {
+                glDeleteRenderbuffers(1, &m_color_buffer);
+            }
+            if (m_depth_buffer != 0) {
+                glDeleteRenderbuffers(1, &m_depth_buffer);
+            }
+            eglMakeCurrent(m_display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+            eglDestroyContext(m_display, m_context);
+        }
+        if (m_surface != EGL_NO_SURFACE) {
+            eglDestroySurface(m_display, m_surface);
+        }
+        if (m_display != EGL_NO_DISPLAY) {
+            eglTerminate(m_display);
+        }
+        m_framebuffer = m_color_buffer = m_depth_buffer = 0;
+        m_surface = EGL_NO_SURFACE;
+        m_context = EGL_NO_CONTEXT;
+        m_display = EGL_NO_DISPLAY;
+    }
+} // namespace di_renderer::headless
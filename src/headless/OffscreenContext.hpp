@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstdint>
+#include <epoxy/egl.h>
+#include <epoxy/gl.h>
+#include <string>
+#include <vector>
+
+namespace di_renderer::headless {
+    // OpenGL 3.3 core context that needs no window system, drawing into a framebuffer object of its own.
+    // Uses Mesa's surfaceless EGL platform when present, which runs on llvmpipe without any GPU, and the default
+    // EGL display otherwise. The context is current on the creating thread for the whole lifetime of the object.
+    class OffscreenContext final {
+      public:
+        // Throws std::runtime_error when no context or framebuffer can be created
+        OffscreenContext(int width, int height);
+        ~OffscreenContext();
+        OffscreenContext(const OffscreenContext&) = delete;
+        OffscreenContext& operator=(const OffscreenContext&) = delete;
+        OffscreenContext(OffscreenContext&&) = delete;
+        OffscreenContext& operator=(OffscreenContext&&) = delete;
+
+        int get_width() const noexcept {
+            return m_width;
+        }
+        int get_height() const noexcept {
+            return m_height;
+        }
+        // GL_RENDERER, e.g. "llvmpipe (LLVM 15.0.6, 256 bits)"
+        std::string get_renderer_name() const;
+
+        // Waits for rendering to finish and returns the framebuffer as tightly packed RGB8 rows, top row first
+        std::vector<std::uint8_t> read_pixels() const;
+
+      private:
+        int m_width;
+        int m_height;
+        EGLDisplay m_display = EGL_NO_DISPLAY;
+        EGLContext m_context = EGL_NO_CONTEXT;
+        // only used when the display can't make a context current without a surface
+        EGLSurface m_surface = EGL_NO_SURFACE;
+        GLuint m_framebuffer = 0;
+        GLuint m_color_buffer = 0;
+        GLuint m_depth_buffer = 0;
+
+        void create_context();
+        void create_framebuffer();
+        void destroy() noexcept;
+    };
+} // namespace di_renderer::headless
@@ -0,0 +1,82 @@
+#include "Options.hpp"
+
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+
+namespace di_renderer::headless {
+    namespace {
+        int parse_positive(const std::string& text) {
+            std::size_t used = 0;
+            const int value = std::stoi(text, &used);
+            if (used != text.size() || value <= 0) {
+                throw std::invalid_argument(text);
+            }
+            return value;
+        }
+
+        math::Vector3 parse_vector(const std::string& text) {
+            std::istringstream stream(text);
+            math::Vector3 value;
+            char first_comma = 0;
+            char second_comma = 0;
+            stream >> value.x >> first_comma >> value.y >> second_comma >> value.z;
+            if (!stream || first_comma != ',' || second_comma != ',' ||
+                stream.peek() != std::char_traits<char>::eof()) {
+                throw std::invalid_argument(text);
+            }
+            return value;
+        }
+    } // namespace
+
+    std::optional<Options> parse_options(const int argc, char** argv) {
+        Options options;
+        const std::vector<std::string> args(argv + 1, argv + argc); // NOLINT(*-pointer-arithmetic)
+        for (std::size_t i = 0; i < args.size(); ++i) {
+            const std::string& arg = args[i];
+            const auto next = [&]() -> const std::string& {
+                if (i + 1 >= args.size()) {
+                    throw std::invalid_argument(arg + " needs a value");
+                }
+                return args[++i];
+            };
+
+            if (arg == "--help" || arg == "-h") {
+                return std::nullopt;
+            }
+            if (arg == "--size") {
+                const std::string& value = next();
+                const std::size_t separator = value.find('x');
+                if (separator == std::string::npos) {
+                    throw std::invalid_argument(value);
+                }
+                options.width = parse_positive(value.substr(0, separator));
+                options.height = parse_positive(value.substr(separator + 1));
+            } else if (arg == "--frames") {
+                options.frames = parse_positive(next());
+            } else if (arg == "--camera") {
+                const std::string& value = next();
+                const std::size_t separator = value.find(':');
+                if (separator == std::string::npos) {
+                    throw std::invalid_argument(value);
+                }
+                options.cameras.emplace_back(parse_vector(value.substr(0, separator)),
+                                             parse_vector(value.substr(separator + 1)));
+            } else if (arg == "--output") {
+                options.output = next();
+            } else if (arg == "--no-images") {
+                options.write_images = false;
+            } else if (arg == "--software") {
+                options.software = true;
+            } else if (arg.rfind("--", 0) == 0) {
+                throw std::invalid_argument("unknown option " + arg);
+            } else {
+                options.models.push_back(arg);
+            }
+        }
+        if (options.models.empty()) {
+            throw std::invalid_argument("no model given");
+        }
+        return options;
+    }
+} // namespace di_renderer::headless
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "math/Vector3.hpp"
+
+#include <filesystem>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace di_renderer::headless {
+    struct Options {
+        int width = 512;
+        int height = 512;
+        int frames = 1;
+        // position and target of every --camera
+        std::vector<std::pair<math::Vector3, math::Vector3>> cameras;
+        std::filesystem::path output = ".";
+        bool write_images = true;
+        bool software = false;
+        std::vector<std::string> models;
+    };
+
+    // Command line of 3d-renderer-headless, argv[0] is skipped. std::nullopt for --help, throws
+    // std::invalid_argument on malformed arguments.
+    std::optional<Options> parse_options(int argc, char** argv);
+} // namespace di_renderer::headless
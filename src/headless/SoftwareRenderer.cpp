@@ -0,0 +1,67 @@
+#include "SoftwareRenderer.hpp"
+
+#include "core/IndexedMesh.hpp"
+#include "math/Frustum.hpp"
+#include "render/Lighting.hpp"
+#include "render/Triangle.hpp"
+
+#include <chrono>
+#include <utility>
+
+namespace di_renderer::headless {
+    SoftwareRenderer::SoftwareRenderer(const int width, const int height) : m_rasterizer(width, height) {}
+
+    void SoftwareRenderer::add_mesh(core::Mesh&& mesh) {
+        const core::IndexedMesh indexed(mesh);
+        SceneMesh& scene_mesh = m_meshes.emplace_back();
+        // same vertex layout as the viewport, v flipped for textures stored top row first
+        scene_mesh.vertices = graphics::get_mesh_vertices(indexed, true);
+        if (indexed.has_16bit_indices()) {
+            scene_mesh.indices.assign(indexed.indices16().begin(), indexed.indices16().end());
+        } else {
+            scene_mesh.indices = indexed.indices32();
+        }
+        scene_mesh.mesh = std::move(mesh);
+    }
+
+    math::BoundingBox SoftwareRenderer::get_scene_bounds() const {
+        math::BoundingBox bounds;
+        for (const auto& scene_mesh : m_meshes) {
+            bounds.expand(scene_mesh.mesh.get_world_bounds());
+        }
+        return bounds;
+    }
+
+    FrameStats SoftwareRenderer::render(math::Camera& camera) {
+        using Clock = std::chrono::steady_clock;
+        FrameStats stats;
+
+        const auto start = Clock::now();
+        prepare_camera(camera, m_rasterizer.get_width(), m_rasterizer.get_height(), get_scene_bounds());
+        m_rasterizer.clear(CLEAR_COLOR);
+
+        graphics::SoftwareShading shading;
+        shading.view_projection = camera.get_view_projection_matrix();
+        shading.light_pos1 = graphics::get_camera_light_position(camera);
+
+        const math::Frustum frustum(camera.get_view_projection_matrix());
+        for (const auto& scene_mesh : m_meshes) {
+            if (scene_mesh.indices.empty() || !frustum.intersects(scene_mesh.mesh.get_world_bounds())) {
+                ++stats.culled;
+                continue;
+            }
+            const math::Transform& transform = scene_mesh.mesh.get_transform();
+            shading.model = transform.get_matrix();
+            shading.normal_matrix = transform.get_normal_matrix();
+            m_rasterizer.draw(scene_mesh.vertices.data(), scene_mesh.vertices.size(), scene_mesh.indices.data(),
+                              scene_mesh.indices.size(), shading);
+            ++stats.drawn;
+        }
+        stats.cpu_ms = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+        return stats;
+    }
+
+    std::vector<std::uint8_t> SoftwareRenderer::read_pixels() const {
+        return m_rasterizer.get_pixels();
+    }
+} // namespace di_renderer::headless
@@ -0,0 +1,40 @@
+#pragma once
+
+#include "Frame.hpp"
+#include "core/Mesh.hpp"
+#include "math/BoundingBox.hpp"
+#include "math/Camera.hpp"
+#include "render/SoftwareRasterizer.hpp"
+#include "render/Vertex.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace di_renderer::headless {
+    // HeadlessRenderer's scene drawn by graphics::SoftwareRasterizer, for machines without a usable GL driver.
+    // Textures are not drawn either.
+    class SoftwareRenderer final {
+      public:
+        // Throws std::runtime_error for an empty size
+        SoftwareRenderer(int width, int height);
+
+        // Builds the mesh's vertex stream right away, the renderer keeps it for all following frames
+        void add_mesh(core::Mesh&& mesh);
+        math::BoundingBox get_scene_bounds() const;
+
+        // Prepares the camera for the image and the scene (see prepare_camera), then draws one frame
+        FrameStats render(math::Camera& camera);
+        // RGB8 rows of the last frame, top row first
+        std::vector<std::uint8_t> read_pixels() const;
+
+      private:
+        struct SceneMesh {
+            core::Mesh mesh;
+            std::vector<graphics::Vertex> vertices;
+            std::vector<std::uint32_t> indices;
+        };
+
+        graphics::SoftwareRasterizer m_rasterizer;
+        std::vector<SceneMesh> m_meshes;
+    };
+} // namespace di_renderer::headless
@@ -0,0 +1,130 @@
+#include "HeadlessRenderer.hpp"
+#include "ImageWriter.hpp"
+#include "Options.hpp"
+#include "SoftwareRenderer.hpp"
+#include "core/Mesh.hpp"
+#include "io/ObjReader.hpp"
+#include "jobs/JobSystem.hpp"
+#include "math/Camera.hpp"
+
+#include <cstddef>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+using namespace di_renderer;
+using di_renderer::headless::Options;
+
+namespace {
+    constexpr int EXIT_OK = 0;
+    constexpr int EXIT_ERROR = 1;
+    constexpr int EXIT_USAGE = 2;
+
+    constexpr std::string_view USAGE = R"(Usage: 3d-renderer-headless [options] model.obj [model.obj ...]
+
+Renders the models offscreen, without a display, and writes one image per camera and the time of every frame.
+
+Options:
+  --size WxH                 framebuffer size, 512x512 by default
+  --frames N                 frames rendered per camera, 1 by default
+  --camera X,Y,Z:TX,TY,TZ    camera position and target, may be repeated. Without one the camera frames the scene
+                             like the viewport does after loading a model
+  --output DIR               directory for camera_<i>.ppm and timings.csv, the current directory by default
+  --no-images                only write timings.csv
+  --software                 draw on the CPU instead of through EGL, for machines without a usable GL driver
+)";
+
+    std::vector<math::Camera> get_cameras(const Options& options, const math::BoundingBox& scene_bounds) {
+        std::vector<math::Camera> cameras;
+        for (const auto& [position, target] : options.cameras) {
+            math::Camera& camera = cameras.emplace_back();
+            camera.set_position(position);
+            camera.set_target(target);
+        }
+        if (cameras.empty()) {
+            cameras.emplace_back().fit_to_bounds(scene_bounds);
+        }
+        return cameras;
+    }
+
+    // Renderer is HeadlessRenderer or SoftwareRenderer
+    template <typename Renderer> void render_scene(Renderer& renderer, const Options& options) {
+        for (const auto& filename : options.models) {
+            // straight from the file, the mesh cache would write next to the user's cache on every run
+            auto [vertices, texture_vertices, normals, faces] =
+                io::ObjReader::read_file(filename, io::ObjReadMode::PARALLEL);
+            renderer.add_mesh(
+                core::Mesh{std::move(vertices), std::move(texture_vertices), std::move(normals), std::move(faces)});
+        }
+
+        fs::create_directories(options.output);
+        const fs::path timings_path = options.output / "timings.csv";
+        std::ofstream timings(timings_path);
+        if (!timings) {
+            throw std::runtime_error("Can't open file: " + timings_path.string());
+        }
+        timings << "camera,frame,cpu_ms,gpu_ms,drawn,culled\n";
+
+        auto cameras = get_cameras(options, renderer.get_scene_bounds());
+        for (std::size_t camera_index = 0; camera_index < cameras.size(); ++camera_index) {
+            double total_cpu_ms = 0.0;
+            for (int frame = 0; frame < options.frames; ++frame) {
+                const auto stats = renderer.render(cameras[camera_index]);
+                total_cpu_ms += stats.cpu_ms;
+                timings << camera_index << ',' << frame << ',' << stats.cpu_ms << ',' << stats.gpu_ms << ','
+                        << stats.drawn << ',' << stats.culled << '\n';
+            }
+            std::cout << "Camera " << camera_index << ": " << total_cpu_ms / options.frames << " ms per frame\n";
+
+            if (options.write_images) {
+                const fs::path image_path = options.output / ("camera_" + std::to_string(camera_index) + ".ppm");
+                headless::write_ppm(image_path.string(), options.width, options.height, renderer.read_pixels());
+            }
+        }
+        if (!timings.flush()) {
+            throw std::runtime_error("Failed to write file: " + timings_path.string());
+        }
+    }
+
+    int run(const Options& options) {
+        if (options.software) {
+            headless::SoftwareRenderer renderer(options.width, options.height);
+            std::cout << "Renderer: software, " << jobs::JobSystem::global().get_thread_count() << " threads\n";
+            render_scene(renderer, options);
+        } else {
+            headless::HeadlessRenderer renderer(options.width, options.height);
+            std::cout << "Renderer: " << renderer.get_context().get_renderer_name() << '\n';
+            render_scene(renderer, options);
+        }
+        return EXIT_OK;
+    }
+} // namespace
+
+int main(int argc, char** argv) {
+    std::optional<Options> options;
+    try {
+        options = headless::parse_options(argc, argv);
+    } catch (const std::exception& e) {
+        std::cerr << "Bad arguments: " << e.what() << "\n\n" << USAGE;
+        return EXIT_USAGE;
+    }
+    if (!options) {
+        std::cout << USAGE;
+        return EXIT_OK;
+    }
+
+    try {
+        return run(*options);
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << '\n';
+        return EXIT_ERROR;
+    }
+}
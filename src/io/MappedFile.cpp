@@ -0,0 +1,75 @@
+#include "MappedFile.hpp"
+
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+namespace di_renderer::io {
+    MappedFile::MappedFile(const std::string& filename) {
+        const int fd = open(filename.c_str(), O_RDONLY | O_CLOEXEC); // NOLINT(*-vararg)
+        if (fd == -1) {
+            throw std::runtime_error("Can't open file");
+        }
+
+        struct stat info{};
+        if (fstat(fd, &info) == -1 || !S_ISREG(info.st_mode)) {
+            close(fd);
+            throw std::runtime_error("Can't open file");
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size == 0) {
+            // mmap refuses empty mappings, an empty view is all we need
+            close(fd);
+            return;
+        }
+
+        void* data = mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd); // the mapping keeps its own reference to the file
+        if (data == MAP_FAILED) { // NOLINT(*-cstyle-cast, performance-no-int-to-ptr)
+            m_size = 0;
+            throw std::runtime_error("Can't map file");
+        }
+
+        madvise(data, m_size, MADV_SEQUENTIAL);
+        m_data = data;
+    }
+
+    MappedFile::~MappedFile() {
+        unmap();
+    }
+
+    MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0)) {}
+
+    MappedFile& MappedFile::operator=(MappedFile&& other) noexcept {
+        if (this != &other) {
+            unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    std::string_view MappedFile::view() const noexcept {
+        if (m_data == nullptr) {
+            return {};
+        }
+        return {static_cast<const char*>(m_data), m_size};
+    }
+
+    std::size_t MappedFile::size() const noexcept {
+        return m_size;
+    }
+
+    void MappedFile::unmap() noexcept {
+        if (m_data != nullptr) {
+            munmap(m_data, m_size);
+            m_data = nullptr;
+        }
+        m_size = 0;
+    }
+} // namespace di_renderer::io
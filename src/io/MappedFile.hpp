@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace di_renderer::io {
+    // Read-only memory mapping of a whole file, unmapped on destruction
+    class MappedFile final {
+      public:
+        explicit MappedFile(const std::string& filename);
+        ~MappedFile();
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        MappedFile(MappedFile&& other) noexcept;
+        MappedFile& operator=(MappedFile&& other) noexcept;
+
+        std::string_view view() const noexcept;
+        std::size_t size() const noexcept;
+
+      private:
+        void* m_data = nullptr;
+        std::size_t m_size = 0;
+
+        void unmap() noexcept;
+    };
+} // namespace di_renderer::io
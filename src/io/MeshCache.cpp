@@ -0,0 +1,266 @@
+#include "MeshCache.hpp"
+
+#include "MappedFile.hpp"
+#include "ObjReader.hpp"
+#include "core/FaceList.hpp"
+#include "core/FaceVerticeData.hpp"
+#include "math/UVCoord.hpp"
+#include "math/Vector3.hpp"
+
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace di_renderer::io {
+    namespace {
+        constexpr std::array<char, 8> MAGIC = {'D', 'I', 'M', 'E', 'S', 'H', 'C', '\0'};
+        constexpr std::uint32_t BYTE_ORDER_MARK = 0x01020304;
+        // load_or_read progress once the OBJ is read and once the mesh is built, storing it takes the rest
+        constexpr float READ_PROGRESS = 0.8f;
+        constexpr float BUILD_PROGRESS = 0.9f;
+
+        // followed by the source path and then the raw vertex, uv, normal, corner and face offset arrays
+        struct Header {
+            std::array<char, 8> magic;
+            std::uint32_t version;
+            std::uint32_t byte_order;
+            std::uint64_t source_size;
+            std::int64_t source_mtime;
+            std::uint64_t path_size;
+            std::uint64_t vertex_count;
+            std::uint64_t texture_vertex_count;
+            std::uint64_t normal_count;
+            std::uint64_t corner_count;
+            std::uint64_t offset_count;
+        };
+
+        static_assert(std::is_trivially_copyable_v<Header>);
+        static_assert(std::is_trivially_copyable_v<math::Vector3> && sizeof(math::Vector3) == 3 * sizeof(float));
+        static_assert(std::is_trivially_copyable_v<math::UVCoord> && sizeof(math::UVCoord) == 2 * sizeof(float));
+        static_assert(std::is_trivially_copyable_v<core::FaceVerticeData> &&
+                      sizeof(core::FaceVerticeData) == 3 * sizeof(int));
+
+        template <typename T> void write_array(std::ofstream& out, const std::vector<T>& values) {
+            out.write(reinterpret_cast<const char*>(values.data()), // NOLINT(*-reinterpret-cast)
+                      static_cast<std::streamsize>(values.size() * sizeof(T)));
+        }
+
+        // Bounds-checked sequential reads over the mapped cache file
+        class Reader {
+          public:
+            explicit Reader(const std::string_view data) noexcept : m_data(data) {}
+
+            template <typename T> bool read(T& value) noexcept {
+                if (m_data.size() - m_pos < sizeof(T)) {
+                    return false;
+                }
+                std::memcpy(&value, m_data.data() + m_pos, sizeof(T)); // NOLINT(*-pointer-arithmetic)
+                m_pos += sizeof(T);
+                return true;
+            }
+
+            template <typename T> bool read_array(std::vector<T>& values, const std::uint64_t count) {
+                if (count > (m_data.size() - m_pos) / sizeof(T)) {
+                    return false;
+                }
+                values.resize(count);
+                std::memcpy(values.data(), m_data.data() + m_pos, count * sizeof(T)); // NOLINT(*-pointer-arithmetic)
+                m_pos += count * sizeof(T);
+                return true;
+            }
+
+            bool read_string(std::string_view& value, const std::uint64_t size) noexcept {
+                if (size > m_data.size() - m_pos) {
+                    return false;
+                }
+                value = m_data.substr(m_pos, size);
+                m_pos += size;
+                return true;
+            }
+
+            bool at_end() const noexcept {
+                return m_pos == m_data.size();
+            }
+
+          private:
+            std::string_view m_data;
+            std::size_t m_pos = 0;
+        };
+    } // namespace
+
+    MeshCache::SourceKey MeshCache::get_source_key(const std::string& filename) {
+        const fs::path path = fs::canonical(filename);
+        return {path.string(), static_cast<std::uint64_t>(fs::file_size(path)),
+                static_cast<std::int64_t>(fs::last_write_time(path).time_since_epoch().count())};
+    }
+
+    fs::path MeshCache::get_cache_path_for_key(const SourceKey& key) {
+        std::ostringstream name;
+        name << std::hex << std::setw(16) << std::setfill('0') << std::hash<std::string>{}(key.path) << ".dmesh";
+        return get_cache_directory() / name.str();
+    }
+
+    core::Mesh MeshCache::load_or_read(const std::string& filename, const ObjReader::ProgressCallback& progress) {
+        if (auto cached = load(filename)) {
+            if (progress) {
+                progress(1.0f);
+            }
+            return std::move(*cached);
+        }
+
+        // reading reports up to READ_PROGRESS, the phases after it report once they are done
+        ObjReader::ProgressCallback read_progress;
+        if (progress) {
+            read_progress = [&progress](const float fraction) { progress(fraction * READ_PROGRESS); };
+        }
+        const auto report = [&progress](const float fraction) {
+            if (progress) {
+                progress(fraction);
+            }
+        };
+
+        // keyed before reading, a file rewritten while it is read must not be cached under its new mtime and size
+        std::optional<SourceKey> key;
+        try {
+            key = get_source_key(filename);
+        } catch (const std::runtime_error&) {
+            // read_file reports why the file can't be read
+        }
+
+        // PARALLEL only splits files of several MIN_PARALLEL_CHUNK_SIZE, smaller ones are parsed like MAPPED
+        auto [vertices, texture_vertices, normals, faces] =
+            ObjReader::read_file(filename, ObjReadMode::PARALLEL, read_progress);
+        report(READ_PROGRESS);
+        core::Mesh mesh{std::move(vertices), std::move(texture_vertices), std::move(normals), std::move(faces)};
+        report(BUILD_PROGRESS);
+        try {
+            if (key && get_source_key(filename) == *key) {
+                store(*key, mesh);
+            }
+        } catch (const std::runtime_error& e) {
+            // the cache is only an accelerator, a read-only cache directory must not break loading
+            std::cerr << "Can't write mesh cache: " << e.what() << '\n';
+        }
+        report(1.0f);
+        return mesh;
+    }
+
+    std::optional<core::Mesh> MeshCache::load(const std::string& filename) {
+        try {
+            const SourceKey key = get_source_key(filename);
+            const fs::path cache_path = get_cache_path_for_key(key);
+            if (!fs::exists(cache_path)) {
+                return std::nullopt;
+            }
+
+            const MappedFile file(cache_path.string());
+            Reader reader(file.view());
+
+            Header header{};
+            std::string_view path;
+            if (!reader.read(header) || header.magic != MAGIC || header.version != VERSION ||
+                header.byte_order != BYTE_ORDER_MARK || !reader.read_string(path, header.path_size) ||
+                path != key.path || header.source_size != key.size || header.source_mtime != key.mtime) {
+                return std::nullopt;
+            }
+
+            std::vector<math::Vector3> vertices;
+            std::vector<math::UVCoord> texture_vertices;
+            std::vector<math::Vector3> normals;
+            std::vector<core::FaceVerticeData> corners;
+            std::vector<std::uint32_t> offsets;
+            if (!reader.read_array(vertices, header.vertex_count) ||
+                !reader.read_array(texture_vertices, header.texture_vertex_count) ||
+                !reader.read_array(normals, header.normal_count) || !reader.read_array(corners, header.corner_count) ||
+                !reader.read_array(offsets, header.offset_count) || !reader.at_end()) {
+                return std::nullopt;
+            }
+
+            core::FaceList faces(std::move(corners), std::move(offsets));
+            return core::Mesh{std::move(vertices), std::move(texture_vertices), std::move(normals), std::move(faces)};
+        } catch (const std::runtime_error&) {
+            return std::nullopt;
+        }
+    }
+
+    void MeshCache::store(const std::string& filename, const core::Mesh& mesh) {
+        store(get_source_key(filename), mesh);
+    }
+
+    void MeshCache::store(const SourceKey& key, const core::Mesh& mesh) {
+        const fs::path cache_path = get_cache_path_for_key(key);
+        fs::create_directories(cache_path.parent_path());
+
+        Header header{};
+        header.magic = MAGIC;
+        header.version = VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.source_size = key.size;
+        header.source_mtime = key.mtime;
+        header.path_size = key.path.size();
+        header.vertex_count = mesh.vertices.size();
+        header.texture_vertex_count = mesh.texture_vertices.size();
+        header.normal_count = mesh.normals.size();
+        header.corner_count = mesh.faces.corner_count();
+        header.offset_count = mesh.faces.offsets().size();
+
+        // Write next to the final file and rename, so readers never observe a half-written entry. The temporary
+        // name is unique per process and call, concurrent stores of one source each publish a complete file.
+        static std::atomic<std::uint64_t> next_temp_id{0};
+        const fs::path temp_path = cache_path.string() + "." + std::to_string(getpid()) + "." +
+                                   std::to_string(next_temp_id.fetch_add(1, std::memory_order_relaxed)) + ".tmp";
+        {
+            std::ofstream out(temp_path, std::ios::binary | std::ios::trunc);
+            if (!out.is_open()) {
+                throw std::runtime_error("Could not open file " + temp_path.string());
+            }
+            out.write(reinterpret_cast<const char*>(&header), sizeof(header)); // NOLINT(*-reinterpret-cast)
+            out.write(key.path.data(), static_cast<std::streamsize>(key.path.size()));
+            write_array(out, mesh.vertices);
+            write_array(out, mesh.texture_vertices);
+            write_array(out, mesh.normals);
+            write_array(out, mesh.faces.corners());
+            write_array(out, mesh.faces.offsets());
+            if (!out.flush()) {
+                out.close();
+                fs::remove(temp_path);
+                throw std::runtime_error("Could not write file " + temp_path.string());
+            }
+        }
+        std::error_code error;
+        fs::rename(temp_path, cache_path, error);
+        if (error) {
+            fs::remove(temp_path, error);
+            throw std::runtime_error("Could not write file " + cache_path.string());
+        }
+    }
+
+    fs::path MeshCache::get_cache_directory() {
+        if (const char* xdg_cache = std::getenv("XDG_CACHE_HOME"); xdg_cache != nullptr && *xdg_cache != '\0') {
+            return fs::path(xdg_cache) / "direnderer";
+        }
+        if (const char* home = std::getenv("HOME"); home != nullptr && *home != '\0') {
+            return fs::path(home) / ".cache" / "direnderer";
+        }
+        return fs::temp_directory_path() / "direnderer";
+    }
+
+    fs::path MeshCache::get_cache_path(const std::string& filename) {
+        return get_cache_path_for_key(get_source_key(filename));
+    }
+} // namespace di_renderer::io
@@ -0,0 +1,48 @@
+#pragma once
+#include "ObjReader.hpp"
+#include "core/Mesh.hpp"
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <string>
+
+namespace di_renderer::io {
+    // Binary snapshot of a loaded (triangulated, normal-computed) mesh, keyed by the source .obj path, mtime and
+    // size. Loading maps the file and copies the arrays straight into the mesh, nothing is parsed.
+    class MeshCache final {
+      public:
+        static constexpr std::uint32_t VERSION = 1;
+
+        // Mesh for filename, from the cache when it is valid, otherwise read with ObjReader in PARALLEL mode and
+        // cached. Besides the reader's reports (from several threads at once for large files), progress also runs
+        // between reading, building the mesh and storing it, so throwing from it cancels a load at the next phase
+        // boundary at the latest.
+        static core::Mesh load_or_read(const std::string& filename,
+                                       const ObjReader::ProgressCallback& progress = nullptr);
+
+        // Cached mesh for filename, std::nullopt if there is no entry or it is stale or corrupt
+        static std::optional<core::Mesh> load(const std::string& filename);
+        static void store(const std::string& filename, const core::Mesh& mesh);
+
+        // $XDG_CACHE_HOME/direnderer, falling back to ~/.cache/direnderer
+        static std::filesystem::path get_cache_directory();
+        static std::filesystem::path get_cache_path(const std::string& filename);
+
+      private:
+        // Identifies one version of a source file, the cache entry for it is only valid while this still matches
+        struct SourceKey {
+            std::string path;
+            std::uint64_t size;
+            std::int64_t mtime;
+
+            bool operator==(const SourceKey& other) const noexcept {
+                return size == other.size && mtime == other.mtime && path == other.path;
+            }
+        };
+
+        static SourceKey get_source_key(const std::string& filename);
+        static std::filesystem::path get_cache_path_for_key(const SourceKey& key);
+        static void store(const SourceKey& key, const core::Mesh& mesh);
+    };
+} // namespace di_renderer::io
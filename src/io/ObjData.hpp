@@ -1,5 +1,5 @@
 #pragma once
-#include "core/FaceVerticeData.hpp"
+#include "core/FaceList.hpp"
 #include "math/UVCoord.hpp"
 #include "math/Vector3.hpp"
 
@@ -10,6 +10,6 @@ namespace di_renderer::io {
         std::vector<math::Vector3> vertices;
         std::vector<math::UVCoord> texture_vertices;
         std::vector<math::Vector3> normals;
-        std::vector<std::vector<core::FaceVerticeData>> faces;
+        core::FaceList faces;
     };
 } // namespace di_renderer::io
@@ -1,17 +1,318 @@
 #include "ObjReader.hpp"
 
+#include "MappedFile.hpp"
 #include "ObjData.hpp"
+#include "jobs/JobSystem.hpp"
 
+#include <algorithm>
+#include <atomic>
+#include <charconv>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <limits>
 #include <math/UVCoord.hpp>
 #include <math/Vector3.hpp>
 #include <regex>
+#include <sstream>
+#include <stdexcept>
 #include <string>
+#include <system_error>
 #include <vector>
 
+namespace {
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    bool is_space(const char c) noexcept {
+        return c == ' ' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    // Walks over a single line the way operator>> walks over a std::stringstream of it
+    class LineCursor {
+      public:
+        explicit LineCursor(const std::string_view line) noexcept
+            : m_pos(line.data()), m_end(line.data() + line.size()) {}
+
+        std::string_view next_token() noexcept {
+            skip_spaces();
+            const char* begin = m_pos;
+            while (m_pos != m_end && !is_space(*m_pos)) {
+                ++m_pos;
+            }
+            return {begin, static_cast<std::size_t>(m_pos - begin)};
+        }
+
+        // a failed read yields 0 and poisons every following read, just like a stream with failbit set
+        float next_float() noexcept {
+            skip_spaces();
+            if (m_failed || m_pos == m_end) {
+                m_failed = true;
+                return 0.0f;
+            }
+
+            const char* begin = *m_pos == '+' ? m_pos + 1 : m_pos; // from_chars rejects an explicit plus
+            float value = 0.0f;
+            const auto [ptr, ec] = std::from_chars(begin, m_end, value);
+            if (ec != std::errc()) {
+                m_failed = true;
+                return 0.0f;
+            }
+            m_pos = ptr;
+            return value;
+        }
+
+        bool failed() const noexcept {
+            return m_failed;
+        }
+
+        bool at_end() noexcept {
+            skip_spaces();
+            return m_pos == m_end;
+        }
+
+      private:
+        const char* m_pos;
+        const char* m_end;
+        bool m_failed = false;
+
+        void skip_spaces() noexcept {
+            while (m_pos != m_end && is_space(*m_pos)) {
+                ++m_pos;
+            }
+        }
+    };
+
+    // 1-based OBJ index to 0-based, returns false if there are no digits at pos
+    bool parse_index(const char*& pos, const char* end, int& index) {
+        const char* begin = pos;
+        std::int64_t value = 0;
+        while (pos != end && *pos >= '0' && *pos <= '9') {
+            value = (value * 10) + (*pos - '0');
+            if (value > std::numeric_limits<int>::max()) {
+                throw std::out_of_range("Face index is out of range");
+            }
+            ++pos;
+        }
+        if (pos == begin) {
+            return false;
+        }
+        index = static_cast<int>(value) - 1;
+        return true;
+    }
+
+    // accepts exactly what ObjReader::FACE_PATTERN accepts: v, v/vt, v//vn, v/vt/vn (trailing slashes allowed)
+    di_renderer::core::FaceVerticeData parse_face_corner(const std::string_view token) {
+        const char* pos = token.data();
+        const char* end = token.data() + token.size();
+        di_renderer::core::FaceVerticeData corner{-1, -1, -1};
+
+        if (!parse_index(pos, end, corner.vi)) {
+            throw std::runtime_error("Bad face pattern");
+        }
+        if (pos != end && *pos == '/') {
+            ++pos;
+        }
+        parse_index(pos, end, corner.ti);
+        if (pos != end && *pos == '/') {
+            ++pos;
+        }
+        parse_index(pos, end, corner.ni);
+
+        if (pos != end) {
+            throw std::runtime_error("Bad face pattern");
+        }
+        return corner;
+    }
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+} // namespace
+
 namespace di_renderer::io {
-    ObjData ObjReader::read_file(const std::string& filename) {
+    ObjData ObjReader::read_file(const std::string& filename, const ObjReadMode mode,
+                                 const ProgressCallback& progress) {
+        if (mode == ObjReadMode::STREAM) {
+            return read_stream(filename, progress);
+        }
+
+        const MappedFile file(filename);
+        if (mode == ObjReadMode::PARALLEL) {
+            const std::size_t max_chunks = jobs::JobSystem::global().get_thread_count();
+            const std::size_t chunk_count =
+                std::clamp(file.size() / MIN_PARALLEL_CHUNK_SIZE, std::size_t{1}, max_chunks);
+            return parse_parallel(file.view(), chunk_count, progress);
+        }
+        return parse(file.view(), progress);
+    }
+
+    ObjData ObjReader::parse(const std::string_view text, const ProgressCallback& progress) {
+        std::size_t parsed_bytes = 0;
+        std::function<void(std::size_t)> advance;
+        if (progress) {
+            advance = [&](const std::size_t bytes) {
+                parsed_bytes += bytes;
+                progress(text.empty() ? 1.0f : static_cast<float>(parsed_bytes) / static_cast<float>(text.size()));
+            };
+        }
+
+        ObjData data;
+        std::vector<std::string_view> skipped_words;
+        parse_chunk(text, data, skipped_words, advance);
+        report_skipped(skipped_words);
+        return data;
+    }
+
+    ObjData ObjReader::parse_parallel(const std::string_view text, const std::size_t chunk_count,
+                                      const ProgressCallback& progress) {
+        if (chunk_count <= 1) {
+            return parse(text, progress);
+        }
+
+        std::atomic<std::size_t> parsed_bytes{0};
+        std::function<void(std::size_t)> advance;
+        if (progress) {
+            advance = [&](const std::size_t bytes) {
+                const std::size_t total = parsed_bytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+                progress(static_cast<float>(total) / static_cast<float>(text.size())); // text isn't empty here
+            };
+        }
+
+        // chunk i covers [bounds[i], bounds[i + 1]), every bound except the last one starts a line
+        std::vector<std::size_t> bounds(chunk_count + 1, text.size());
+        bounds[0] = 0;
+        for (std::size_t i = 1; i < chunk_count; ++i) {
+            const std::size_t approx = std::max(bounds[i - 1], text.size() / chunk_count * i);
+            const std::size_t line_end = approx == 0 ? std::string_view::npos : text.find('\n', approx - 1);
+            bounds[i] = line_end == std::string_view::npos ? text.size() : line_end + 1;
+        }
+
+        struct Chunk {
+            ObjData data;
+            std::vector<std::string_view> skipped_words;
+            std::exception_ptr error;
+        };
+        std::vector<Chunk> chunks(chunk_count);
+        jobs::JobSystem::global().parallel_for_each(chunk_count, [&](const std::size_t i) {
+            Chunk& chunk = chunks[i];
+            try {
+                parse_chunk(text.substr(bounds[i], bounds[i + 1] - bounds[i]), chunk.data, chunk.skipped_words,
+                            advance);
+            } catch (...) {
+                chunk.error = std::current_exception();
+            }
+        });
+
+        // every chunk has finished here, surface the earliest error in file order
+        for (const auto& chunk : chunks) {
+            if (chunk.error) {
+                std::rethrow_exception(chunk.error);
+            }
+        }
+
+        // OBJ indices are absolute (relative ones are rejected by the face pattern), so chunks can simply be
+        // concatenated in file order without touching FaceVerticeData
+        ObjData data;
+        std::size_t vertex_count = 0;
+        std::size_t texture_vertex_count = 0;
+        std::size_t normal_count = 0;
+        std::size_t face_count = 0;
+        std::size_t corner_count = 0;
+        for (const auto& chunk : chunks) {
+            vertex_count += chunk.data.vertices.size();
+            texture_vertex_count += chunk.data.texture_vertices.size();
+            normal_count += chunk.data.normals.size();
+            face_count += chunk.data.faces.size();
+            corner_count += chunk.data.faces.corner_count();
+        }
+        data.vertices.reserve(vertex_count);
+        data.texture_vertices.reserve(texture_vertex_count);
+        data.normals.reserve(normal_count);
+        data.faces.reserve(face_count, corner_count);
+
+        for (auto& chunk : chunks) {
+            data.vertices.insert(data.vertices.end(), chunk.data.vertices.begin(), chunk.data.vertices.end());
+            data.texture_vertices.insert(data.texture_vertices.end(), chunk.data.texture_vertices.begin(),
+                                         chunk.data.texture_vertices.end());
+            data.normals.insert(data.normals.end(), chunk.data.normals.begin(), chunk.data.normals.end());
+            data.faces.append(chunk.data.faces);
+            report_skipped(chunk.skipped_words);
+            chunk = {};
+        }
+        return data;
+    }
+
+    void ObjReader::parse_chunk(const std::string_view text, ObjData& data,
+                                std::vector<std::string_view>& skipped_words,
+                                const std::function<void(std::size_t)>& advance) {
+        std::vector<core::FaceVerticeData> face_vertices;
+
+        std::size_t reported_bytes = 0;
+        std::size_t line_begin = 0;
+        while (line_begin < text.size()) {
+            if (advance && line_begin - reported_bytes >= PROGRESS_STEP) {
+                advance(line_begin - reported_bytes);
+                reported_bytes = line_begin;
+            }
+
+            std::size_t line_end = text.find('\n', line_begin);
+            if (line_end == std::string_view::npos) {
+                line_end = text.size();
+            }
+            const std::string_view line = text.substr(line_begin, line_end - line_begin);
+            line_begin = line_end + 1;
+
+            if (line.empty() || line == "\r" || line[0] == '#') {
+                continue;
+            }
+
+            LineCursor cursor(line);
+            const std::string_view word = cursor.next_token();
+            if (word == "v") {
+                const float x = cursor.next_float();
+                const float y = cursor.next_float();
+                const float z = cursor.next_float();
+                if (cursor.failed()) {
+                    throw std::runtime_error("Bad vertex data");
+                }
+                data.vertices.emplace_back(x, y, z);
+            } else if (word == "vt") {
+                const float u = cursor.next_float();
+                const float v = cursor.at_end() ? 0.0f : cursor.next_float();
+                if (cursor.failed()) {
+                    throw std::runtime_error("Bad vertex data");
+                }
+                data.texture_vertices.emplace_back(u, v);
+            } else if (word == "vn") {
+                const float x = cursor.next_float();
+                const float y = cursor.next_float();
+                const float z = cursor.next_float();
+                if (cursor.failed()) {
+                    throw std::runtime_error("Bad vertex data");
+                }
+                data.normals.emplace_back(x, y, z);
+            } else if (word == "f") {
+                face_vertices.clear();
+                for (auto token = cursor.next_token(); !token.empty(); token = cursor.next_token()) {
+                    face_vertices.push_back(parse_face_corner(token));
+                }
+                data.faces.append(face_vertices.begin(), face_vertices.end());
+            } else if (is_unsupported(word)) {
+                skipped_words.push_back(word);
+            } else {
+                throw std::runtime_error("Bad .obj file");
+            }
+        }
+
+        if (advance) {
+            advance(text.size() - reported_bytes);
+        }
+    }
+
+    void ObjReader::report_skipped(const std::vector<std::string_view>& skipped_words) {
+        for (const auto word : skipped_words) {
+            std::cout << "Skipped unsupported word: " << word << '\n';
+        }
+    }
+
+    ObjData ObjReader::read_stream(const std::string& filename, const ProgressCallback& progress) {
         std::ifstream file(filename);
         if (!file.is_open()) {
             throw std::runtime_error("Can't open file");
@@ -21,7 +322,7 @@ namespace di_renderer::io {
         std::vector<math::Vector3> vertices;
         std::vector<math::UVCoord> texture_vertices;
         std::vector<math::Vector3> normals;
-        std::vector<std::vector<core::FaceVerticeData>> faces;
+        core::FaceList faces;
         float x, y, z, u, v; // NOLINT
 
         while (std::getline(file, line)) {
@@ -33,13 +334,21 @@ namespace di_renderer::io {
             std::string word;
             ss >> word;
             if (word == "v") {
-                ss >> x >> y >> z;
+                if (!(ss >> x >> y >> z)) {
+                    throw std::runtime_error("Bad vertex data");
+                }
                 vertices.emplace_back(x, y, z);
             } else if (word == "vt") {
-                ss >> u >> v;
+                // v is optional and defaults to 0
+                v = 0.0f;
+                if (!(ss >> u) || (!(ss >> std::ws).eof() && !(ss >> v))) {
+                    throw std::runtime_error("Bad vertex data");
+                }
                 texture_vertices.emplace_back(u, v);
             } else if (word == "vn") {
-                ss >> x >> y >> z;
+                if (!(ss >> x >> y >> z)) {
+                    throw std::runtime_error("Bad vertex data");
+                }
                 normals.emplace_back(x, y, z);
             } else if (word == "f") {
                 std::vector<core::FaceVerticeData> face_vertices;
@@ -55,14 +364,22 @@ namespace di_renderer::io {
 
                     face_vertices.push_back({vertice_index, texture_index, normal_index});
                 }
-                faces.push_back(face_vertices);
-            } else if (UNSUPPORTED_LINES.find(word) != UNSUPPORTED_LINES.end()) {
+                faces.append(face_vertices.begin(), face_vertices.end());
+            } else if (is_unsupported(word)) {
                 std::cout << "Skipped unsupported word: " << word << '\n';
             } else {
                 throw std::runtime_error("Bad .obj file");
             }
         }
 
-        return {vertices, texture_vertices, normals, faces};
+        // the reference reader only reports completion
+        if (progress) {
+            progress(1.0f);
+        }
+        return {std::move(vertices), std::move(texture_vertices), std::move(normals), std::move(faces)};
+    }
+
+    bool ObjReader::is_unsupported(const std::string_view word) noexcept {
+        return std::find(UNSUPPORTED_LINES.begin(), UNSUPPORTED_LINES.end(), word) != UNSUPPORTED_LINES.end();
     }
 } // namespace di_renderer::io
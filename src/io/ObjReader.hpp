@@ -1,16 +1,50 @@
 #pragma once
 #include "ObjData.hpp"
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <regex>
-#include <unordered_set>
+#include <string>
+#include <string_view>
 
 namespace di_renderer::io {
+    enum class ObjReadMode : std::uint8_t {
+        STREAM = 0,   // std::getline + regex, kept as the reference implementation
+        MAPPED = 1,   // memory-mapped file parsed in place
+        PARALLEL = 2, // memory-mapped file split at line boundaries and parsed on the shared job system
+    };
+
     class ObjReader {
       public:
-        static ObjData read_file(const std::string& filename);
+        // Receives the fraction of the input parsed so far, in PARALLEL mode from several threads at once.
+        // Throwing from it aborts reading with that exception.
+        using ProgressCallback = std::function<void(float)>;
+
+        static ObjData read_file(const std::string& filename, ObjReadMode mode = ObjReadMode::MAPPED,
+                                 const ProgressCallback& progress = nullptr);
+
+        // Parses OBJ text that is already in memory, follows the same rules and errors as read_file
+        static ObjData parse(std::string_view text, const ProgressCallback& progress = nullptr);
+        // Same as parse, but splits the text into chunk_count line-aligned chunks that are parsed concurrently
+        static ObjData parse_parallel(std::string_view text, std::size_t chunk_count,
+                                      const ProgressCallback& progress = nullptr);
 
       private:
+        // chunks smaller than this are not worth a thread of their own
+        static constexpr std::size_t MIN_PARALLEL_CHUNK_SIZE = std::size_t{4} << 20U;
+        // bytes parsed between two progress reports
+        static constexpr std::size_t PROGRESS_STEP = std::size_t{1} << 20U;
+
         inline static const std::regex FACE_PATTERN{R"((\d+)\/?(\d*)\/?(\d*))"};
-        inline static const std::unordered_set<std::string> UNSUPPORTED_LINES{"o", "g", "s", "usemtl", "mtllib", "vp"};
+        static constexpr std::array<std::string_view, 6> UNSUPPORTED_LINES{"o",      "g",      "s",
+                                                                           "usemtl", "mtllib", "vp"};
+
+        static ObjData read_stream(const std::string& filename, const ProgressCallback& progress);
+        static void parse_chunk(std::string_view text, ObjData& data, std::vector<std::string_view>& skipped_words,
+                                const std::function<void(std::size_t)>& advance);
+        static void report_skipped(const std::vector<std::string_view>& skipped_words);
+        static bool is_unsupported(std::string_view word) noexcept;
     };
 } // namespace di_renderer::io
@@ -1,50 +1,203 @@
 #include "ObjWriter.hpp"
 
+#include "jobs/JobSystem.hpp"
+#include "math/BatchTransforms.hpp"
+#include "math/UVCoord.hpp"
+#include "math/Vector3.hpp"
+
+#include <algorithm>
+#include <charconv>
 #include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
 
 namespace di_renderer::io {
-    void ObjWriter::write_file(const std::string& filename, const core::Mesh& mesh) {
-        std::ofstream file(filename);
-        if (!file.is_open()) {
-            throw std::runtime_error("Could not open file " + filename);
-        }
-        file << "# Generated with Di-Renderer ObjWriter\n\n";
+    namespace {
+        constexpr std::string_view HEADER = "# Generated with Di-Renderer ObjWriter\n\n";
+        constexpr std::size_t SECTION_COUNT = 4;
+        // 9 significant digits already round-trip any float
+        constexpr int MAX_PRECISION = 9;
+        // longest field: a float in scientific notation with MAX_PRECISION digits, or an index
+        constexpr std::size_t MAX_FIELD_SIZE = 32;
 
-        // vertices
-        for (const auto& v : mesh.vertices) {
-            file << "v " << v.x << " " << v.y << " " << v.z << '\n';
-        }
-        file << '\n';
+        // Growable text buffer formatted with to_chars, so output is independent of the global locale
+        class TextBuffer {
+          public:
+            explicit TextBuffer(const std::size_t capacity) : m_data(capacity) {}
+
+            void put(const char c) {
+                *reserve(1) = c;
+                ++m_size;
+            }
+
+            void put(const std::string_view text) {
+                std::copy(text.begin(), text.end(), reserve(text.size()));
+                m_size += text.size();
+            }
+
+            // precision 0 is the shortest round-trip form
+            void put_float(const float value, const int precision) {
+                char* first = reserve(MAX_FIELD_SIZE);
+                char* last = first + MAX_FIELD_SIZE; // NOLINT(*-pointer-arithmetic)
+                const auto result = precision > 0
+                                        ? std::to_chars(first, last, value, std::chars_format::general, precision)
+                                        : std::to_chars(first, last, value);
+                m_size += static_cast<std::size_t>(result.ptr - first);
+            }
+
+            void put_index(const int value) {
+                char* first = reserve(MAX_FIELD_SIZE);
+                const auto result = std::to_chars(first, first + MAX_FIELD_SIZE, value); // NOLINT(*-pointer-arithmetic)
+                m_size += static_cast<std::size_t>(result.ptr - first);
+            }
+
+            std::size_t size() const noexcept {
+                return m_size;
+            }
+
+            void write_to(std::ofstream& file) const {
+                file.write(m_data.data(), static_cast<std::streamsize>(m_size));
+            }
+
+            // keeps the capacity for the next lines
+            void clear() noexcept {
+                m_size = 0;
+            }
+
+          private:
+            std::vector<char> m_data;
+            std::size_t m_size = 0;
 
-        // texture vertices
-        for (const auto& vt : mesh.texture_vertices) {
-            file << "vt " << vt.u << " " << vt.v << '\n';
+            char* reserve(const std::size_t count) {
+                if (m_size + count > m_data.size()) {
+                    m_data.resize(std::max(m_data.size() * 2, m_size + count));
+                }
+                return m_data.data() + m_size; // NOLINT(*-pointer-arithmetic)
+            }
+        };
+
+        // Every section ends with an empty line. end_line runs after each line and may flush the buffer.
+        template <typename EndLine>
+        void format_vectors(TextBuffer& buffer, const std::string_view prefix, const std::vector<math::Vector3>& values,
+                            const int precision, const EndLine& end_line) {
+            for (const auto& value : values) {
+                buffer.put(prefix);
+                buffer.put_float(value.x, precision);
+                buffer.put(' ');
+                buffer.put_float(value.y, precision);
+                buffer.put(' ');
+                buffer.put_float(value.z, precision);
+                buffer.put('\n');
+                end_line();
+            }
+            buffer.put('\n');
         }
-        file << '\n';
 
-        // normals
-        for (const auto& n : mesh.normals) {
-            file << "vn " << n.x << " " << n.y << " " << n.z << '\n';
+        template <typename EndLine>
+        void format_texture_vertices(TextBuffer& buffer, const std::vector<math::UVCoord>& values, const int precision,
+                                     const EndLine& end_line) {
+            for (const auto& value : values) {
+                buffer.put("vt ");
+                buffer.put_float(value.u, precision);
+                buffer.put(' ');
+                buffer.put_float(value.v, precision);
+                buffer.put('\n');
+                end_line();
+            }
+            buffer.put('\n');
         }
-        file << '\n';
-
-        // faces
-        for (const auto& vec : mesh.faces) {
-            file << "f ";
-            for (const auto [vi, ti, ni] : vec) {
-                file << vi + 1; // 1
-                if (ti != -1) {
-                    file << '/' << ti + 1; // 1/2
-                    if (ni != -1) {
-                        file << '/' << ni + 1; // 1/2/3
+
+        template <typename EndLine>
+        void format_faces(TextBuffer& buffer, const core::FaceList& faces, const EndLine& end_line) {
+            for (const auto face : faces) {
+                buffer.put("f ");
+                for (const auto [vi, ti, ni] : face) {
+                    buffer.put_index(vi + 1); // 1
+                    if (ti != -1) {
+                        buffer.put('/');
+                        buffer.put_index(ti + 1); // 1/2
+                        if (ni != -1) {
+                            buffer.put('/');
+                            buffer.put_index(ni + 1); // 1/2/3
+                        }
+                    } else if (ni != -1) {
+                        buffer.put("//");
+                        buffer.put_index(ni + 1); // 1//3
                     }
-                } else if (ni != -1) {
-                    file << "//" << ni + 1; // 1//3
+
+                    buffer.put(' ');
                 }
+                buffer.put('\n');
+                end_line();
+            }
+        }
+    } // namespace
 
-                file << " ";
+    void ObjWriter::write_file(const std::string& filename, const core::Mesh& mesh, const bool apply_transform,
+                               const ObjWriteOptions& options) {
+        std::ofstream file(filename, std::ios::binary);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+
+        std::vector<math::Vector3> baked_vertices;
+        std::vector<math::Vector3> baked_normals;
+        if (apply_transform) {
+            const auto& transform = mesh.get_transform();
+            baked_vertices.resize(mesh.vertices.size());
+            math::BatchTransforms::transform_points(transform.get_matrix(), mesh.vertices.data(),
+                                                    baked_vertices.data(), mesh.vertices.size(), 0);
+            baked_normals.resize(mesh.normals.size());
+            math::BatchTransforms::transform_normals(transform.get_normal_matrix(), mesh.normals.data(),
+                                                     baked_normals.data(), mesh.normals.size(), 0);
+        }
+        const auto& vertices = apply_transform ? baked_vertices : mesh.vertices;
+        const auto& normals = apply_transform ? baked_normals : mesh.normals;
+        const int precision = std::min(options.precision, MAX_PRECISION);
+
+        if (options.parallel_sections) {
+            std::vector<TextBuffer> sections(SECTION_COUNT, TextBuffer(FLUSH_SIZE));
+            const auto no_flush = [] {};
+            jobs::JobSystem::global().parallel_for_each(SECTION_COUNT, [&](const std::size_t section) {
+                switch (section) {
+                case 0:
+                    format_vectors(sections[0], "v ", vertices, precision, no_flush);
+                    break;
+                case 1:
+                    format_texture_vertices(sections[1], mesh.texture_vertices, precision, no_flush);
+                    break;
+                case 2:
+                    format_vectors(sections[2], "vn ", normals, precision, no_flush);
+                    break;
+                default:
+                    format_faces(sections[3], mesh.faces, no_flush);
+                    break;
+                }
+            });
+            file.write(HEADER.data(), static_cast<std::streamsize>(HEADER.size()));
+            for (const auto& section : sections) {
+                section.write_to(file);
             }
-            file << '\n';
+        } else {
+            // one line past FLUSH_SIZE fits without growing, faces with many corners are the exception
+            TextBuffer buffer(FLUSH_SIZE + (MAX_FIELD_SIZE * 8));
+            const auto flush_full = [&] {
+                if (buffer.size() >= FLUSH_SIZE) {
+                    buffer.write_to(file);
+                    buffer.clear();
+                }
+            };
+            buffer.put(HEADER);
+            format_vectors(buffer, "v ", vertices, precision, flush_full);
+            format_texture_vertices(buffer, mesh.texture_vertices, precision, flush_full);
+            format_vectors(buffer, "vn ", normals, precision, flush_full);
+            format_faces(buffer, mesh.faces, flush_full);
+            buffer.write_to(file);
+        }
+
+        if (!file.flush()) {
+            throw std::runtime_error("Could not write file " + filename);
         }
     }
 } // namespace di_renderer::io
@@ -1,11 +1,26 @@
 #pragma once
 #include "core/Mesh.hpp"
 
+#include <cstddef>
 #include <string>
 
 namespace di_renderer::io {
+    struct ObjWriteOptions {
+        // Significant digits per coordinate, at most 9. 0 writes the shortest text that reads back as the same float.
+        int precision = 0;
+        // Formats the vertex, texture vertex, normal and face sections concurrently on the shared job system and
+        // writes them in order. Holds the whole file in memory instead of one buffer of FLUSH_SIZE.
+        bool parallel_sections = false;
+    };
+
     class ObjWriter {
       public:
-        static void write_file(const std::string& filename, const core::Mesh& mesh);
+        // text is formatted into a reused buffer and written out whenever it holds this many bytes
+        static constexpr std::size_t FLUSH_SIZE = std::size_t{1} << 20U;
+
+        // With apply_transform the mesh's transform is baked into the written vertices and normals.
+        // Throws std::runtime_error when the file can't be opened or written.
+        static void write_file(const std::string& filename, const core::Mesh& mesh, bool apply_transform = false,
+                               const ObjWriteOptions& options = {});
     };
 } // namespace di_renderer::io
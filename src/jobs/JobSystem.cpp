@@ -0,0 +1,218 @@
+#include "JobSystem.hpp"
+
+#include <cstdlib>
+#include <string>
+
+namespace di_renderer::jobs {
+    namespace {
+        // chunks per thread parallel_for aims for when the caller doesn't cap them
+        constexpr std::size_t CHUNKS_PER_THREAD = 4;
+
+        // pool and queue index of the worker running on this thread, unset outside any pool
+        thread_local const JobSystem* current_system = nullptr;
+        thread_local std::size_t current_queue_index = 0;
+
+        std::mutex global_mutex;                  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+        std::unique_ptr<JobSystem> global_system; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+        std::size_t get_default_thread_count() {
+            if (const char* value = std::getenv("DI_RENDERER_THREADS"); value != nullptr && *value != '\0') {
+                try {
+                    // signed, stoul would turn "-1" into a huge pool
+                    if (const long count = std::stol(value); count >= 1) {
+                        return static_cast<std::size_t>(count);
+                    }
+                } catch (const std::exception&) { // NOLINT(bugprone-empty-catch)
+                    // not a number, fall back to the hardware
+                }
+            }
+            return 0;
+        }
+    } // namespace
+
+    JobSystem::JobSystem(std::size_t thread_count) {
+        if (thread_count == 0) {
+            thread_count = std::max(1U, std::thread::hardware_concurrency());
+        }
+
+        m_worker_count = thread_count - 1;
+        m_queues.reserve(m_worker_count + 1);
+        for (std::size_t i = 0; i <= m_worker_count; ++i) {
+            m_queues.push_back(std::make_unique<Queue>());
+        }
+        m_workers.reserve(m_worker_count);
+        try {
+            for (std::size_t i = 0; i < m_worker_count; ++i) {
+                m_workers.emplace_back([this, i] { worker_loop(i); });
+            }
+        } catch (...) {
+            // the destructor doesn't run for a throwing constructor, and joinable threads terminate when destroyed
+            stop_workers();
+            throw;
+        }
+    }
+
+    JobSystem::~JobSystem() {
+        stop_workers();
+    }
+
+    void JobSystem::stop_workers() noexcept {
+        {
+            const std::lock_guard lock(m_sleep_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_all();
+        for (auto& worker : m_workers) {
+            worker.join();
+        }
+    }
+
+    JobSystem& JobSystem::global() {
+        const std::lock_guard lock(global_mutex);
+        if (!global_system) {
+            global_system = std::make_unique<JobSystem>(get_default_thread_count());
+        }
+        return *global_system;
+    }
+
+    void JobSystem::set_global_thread_count(const std::size_t thread_count) {
+        const std::lock_guard lock(global_mutex);
+        global_system.reset();
+        global_system = std::make_unique<JobSystem>(thread_count);
+    }
+
+    std::size_t JobSystem::get_chunk_count(const std::size_t count, const std::size_t min_chunk_size,
+                                           const std::size_t max_chunks) const noexcept {
+        if (count == 0) {
+            return 0;
+        }
+        const std::size_t limit = max_chunks == 0 ? get_thread_count() * CHUNKS_PER_THREAD : max_chunks;
+        const std::size_t by_size = min_chunk_size == 0 ? count : count / min_chunk_size;
+        // one thread gains nothing from splitting
+        return m_worker_count == 0 ? 1 : std::clamp<std::size_t>(by_size, 1, limit);
+    }
+
+    std::pair<std::size_t, std::size_t> JobSystem::get_chunk_bounds(const std::size_t count,
+                                                                    const std::size_t chunk_count,
+                                                                    const std::size_t index) noexcept {
+        // the first count % chunk_count ranges are one item longer
+        const std::size_t size = count / chunk_count;
+        const std::size_t remainder = count % chunk_count;
+        const std::size_t begin = (index * size) + std::min(index, remainder);
+        return {begin, begin + size + (index < remainder ? 1 : 0)};
+    }
+
+    void JobSystem::submit(Task task, TaskGroup& group) {
+        group.m_pending.fetch_add(1, std::memory_order_relaxed);
+        Queue& queue = *m_queues[get_own_queue_index()];
+        {
+            const std::lock_guard lock(queue.mutex);
+            queue.jobs.push_back({std::move(task), &group});
+        }
+        {
+            const std::lock_guard lock(m_sleep_mutex);
+            m_queued.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_wake.notify_one();
+    }
+
+    bool JobSystem::run_one() {
+        const std::size_t own = get_own_queue_index();
+        const bool is_worker = own != m_worker_count;
+
+        // workers take their newest job, which is still warm in cache. Outside threads take the oldest shared one
+        // so a pool without workers runs jobs in submission order.
+        Job job;
+        bool found = pop(own, is_worker, job);
+        for (std::size_t i = 1; !found && i < m_queues.size(); ++i) {
+            found = pop((own + i) % m_queues.size(), false, job);
+        }
+        if (!found) {
+            return false;
+        }
+
+        std::exception_ptr error;
+        try {
+            job.task();
+        } catch (...) {
+            error = std::current_exception();
+        }
+        job.group->finish(error);
+        return true;
+    }
+
+    bool JobSystem::pop(const std::size_t queue_index, const bool newest, Job& job) {
+        Queue& queue = *m_queues[queue_index];
+        const std::lock_guard lock(queue.mutex);
+        if (queue.jobs.empty()) {
+            return false;
+        }
+        if (newest) {
+            job = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+        } else {
+            job = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+        }
+        m_queued.fetch_sub(1, std::memory_order_relaxed);
+        return true;
+    }
+
+    void JobSystem::worker_loop(const std::size_t index) {
+        current_system = this;
+        current_queue_index = index;
+        while (true) {
+            if (run_one()) {
+                continue;
+            }
+            std::unique_lock lock(m_sleep_mutex);
+            m_wake.wait(lock, [this] { return m_stopping || m_queued.load(std::memory_order_relaxed) > 0; });
+            if (m_stopping) {
+                return;
+            }
+        }
+    }
+
+    std::size_t JobSystem::get_own_queue_index() const noexcept {
+        return current_system == this ? current_queue_index : m_worker_count;
+    }
+
+    TaskGroup::~TaskGroup() {
+        wait_idle();
+    }
+
+    void TaskGroup::run(JobSystem::Task task) {
+        m_system.submit(std::move(task), *this);
+    }
+
+    void TaskGroup::wait() {
+        wait_idle();
+        std::exception_ptr error;
+        {
+            const std::lock_guard lock(m_error_mutex);
+            error = std::exchange(m_error, nullptr);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    void TaskGroup::wait_idle() noexcept {
+        while (m_pending.load(std::memory_order_acquire) != 0) {
+            // the remaining jobs are running elsewhere when there is nothing left to help with
+            if (!m_system.run_one()) {
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    void TaskGroup::finish(std::exception_ptr error) noexcept {
+        if (error) {
+            const std::lock_guard lock(m_error_mutex);
+            if (!m_error) {
+                m_error = std::move(error);
+            }
+        }
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+    }
+} // namespace di_renderer::jobs
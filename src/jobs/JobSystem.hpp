@@ -0,0 +1,178 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace di_renderer::jobs {
+    class TaskGroup;
+
+    // Work-stealing thread pool. Every worker owns a queue: it runs its own tasks newest first and steals the
+    // oldest ones from the others when it runs dry. Threads outside the pool submit to a shared queue and run
+    // tasks themselves while they wait, so nested parallel loops never block a worker on work nobody picks up.
+    //
+    // A pool with thread_count 1 starts no workers: tasks run on the waiting thread, in submission order, which
+    // makes the results of any parallel algorithm on it deterministic.
+    class JobSystem final {
+      public:
+        using Task = std::function<void()>;
+
+        // 0 uses every hardware thread, the thread that waits counts as one of them
+        explicit JobSystem(std::size_t thread_count = 0);
+        ~JobSystem();
+        JobSystem(const JobSystem&) = delete;
+        JobSystem& operator=(const JobSystem&) = delete;
+        JobSystem(JobSystem&&) = delete;
+        JobSystem& operator=(JobSystem&&) = delete;
+
+        // Pool shared by loading and mesh processing. Sized by the DI_RENDERER_THREADS environment variable when it
+        // holds a positive number, every hardware thread otherwise.
+        static JobSystem& global();
+        // Replaces the shared pool. Nothing may be running on the old one.
+        static void set_global_thread_count(std::size_t thread_count);
+
+        std::size_t get_thread_count() const noexcept {
+            return m_worker_count + 1;
+        }
+
+        // How many ranges parallel_for splits count items into: none shorter than min_chunk_size and at most
+        // max_chunks of them, 0 allowing a few per thread so stealing can even out uneven ranges
+        std::size_t get_chunk_count(std::size_t count, std::size_t min_chunk_size,
+                                    std::size_t max_chunks = 0) const noexcept;
+        // [begin, end) of range index out of chunk_count equal ranges over count items
+        static std::pair<std::size_t, std::size_t> get_chunk_bounds(std::size_t count, std::size_t chunk_count,
+                                                                     std::size_t index) noexcept;
+
+        // Runs body(index) for every index in [0, count) and returns once all are done. Rethrows the first
+        // exception a call threw, the remaining calls still run.
+        template <typename Body> void parallel_for_each(std::size_t count, const Body& body);
+
+        // Runs body(begin, end) over get_chunk_count ranges covering [0, count)
+        template <typename Body>
+        void parallel_for(const std::size_t count, const std::size_t min_chunk_size, const Body& body,
+                          const std::size_t max_chunks = 0) {
+            const std::size_t chunk_count = get_chunk_count(count, min_chunk_size, max_chunks);
+            parallel_for_each(chunk_count, [&](const std::size_t index) {
+                const auto [begin, end] = get_chunk_bounds(count, chunk_count, index);
+                body(begin, end);
+            });
+        }
+
+        // Same as parallel_for, collecting what body returns for each range in range order
+        template <typename Body>
+        auto parallel_map(const std::size_t count, const std::size_t min_chunk_size, const Body& body,
+                          const std::size_t max_chunks = 0) {
+            using Result = std::invoke_result_t<const Body&, std::size_t, std::size_t>;
+            static_assert(!std::is_same_v<Result, bool>, "std::vector<bool> can't be written from several threads");
+            const std::size_t chunk_count = get_chunk_count(count, min_chunk_size, max_chunks);
+            std::vector<Result> results(chunk_count);
+            parallel_for_each(chunk_count, [&](const std::size_t index) {
+                const auto [begin, end] = get_chunk_bounds(count, chunk_count, index);
+                results[index] = body(begin, end);
+            });
+            return results;
+        }
+
+      private:
+        friend class TaskGroup;
+
+        struct Job {
+            Task task;
+            TaskGroup* group = nullptr;
+        };
+
+        struct Queue {
+            std::mutex mutex;
+            std::deque<Job> jobs;
+        };
+
+        // fixed before any worker starts, unlike m_workers which is still filling while the first ones run
+        std::size_t m_worker_count = 0;
+        // one queue per worker, the last one is shared by every thread outside the pool
+        std::vector<std::unique_ptr<Queue>> m_queues;
+        std::vector<std::thread> m_workers;
+
+        // jobs sitting in any queue, only raised under m_sleep_mutex so sleeping workers never miss a wake-up
+        std::atomic<std::size_t> m_queued{0};
+        std::mutex m_sleep_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+
+        void submit(Task task, TaskGroup& group);
+        // Runs one queued job if there is any, returns whether it did
+        bool run_one();
+        bool pop(std::size_t queue_index, bool newest, Job& job);
+        void worker_loop(std::size_t index);
+        // wakes every started worker and joins it
+        void stop_workers() noexcept;
+        std::size_t get_own_queue_index() const noexcept;
+    };
+
+    // Set of tasks submitted together. wait() helps running queued tasks until every task of the group is done
+    // and rethrows the first exception one of them threw. Destroying a group waits for it, dropping errors.
+    class TaskGroup final {
+      public:
+        explicit TaskGroup(JobSystem& system) noexcept : m_system(system) {}
+        ~TaskGroup();
+        TaskGroup(const TaskGroup&) = delete;
+        TaskGroup& operator=(const TaskGroup&) = delete;
+        TaskGroup(TaskGroup&&) = delete;
+        TaskGroup& operator=(TaskGroup&&) = delete;
+
+        void run(JobSystem::Task task);
+        void wait();
+
+      private:
+        friend class JobSystem;
+
+        JobSystem& m_system;
+        std::atomic<std::size_t> m_pending{0};
+        std::mutex m_error_mutex;
+        std::exception_ptr m_error;
+
+        void wait_idle() noexcept;
+        void finish(std::exception_ptr error) noexcept;
+    };
+
+    template <typename Body> void JobSystem::parallel_for_each(const std::size_t count, const Body& body) {
+        if (count <= 1 || m_worker_count == 0) {
+            std::exception_ptr error;
+            for (std::size_t i = 0; i < count; ++i) {
+                try {
+                    body(i);
+                } catch (...) {
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+            }
+            if (error) {
+                std::rethrow_exception(error);
+            }
+            return;
+        }
+
+        TaskGroup group(*this);
+        // the caller takes index 0 itself instead of queueing it and then waiting
+        for (std::size_t i = 1; i < count; ++i) {
+            group.run([&body, i] { body(i); });
+        }
+        try {
+            body(0);
+        } catch (...) {
+            group.wait_idle();
+            throw;
+        }
+        group.wait();
+    }
+} // namespace di_renderer::jobs
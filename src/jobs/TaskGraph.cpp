@@ -0,0 +1,55 @@
+#include "TaskGraph.hpp"
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace di_renderer::jobs {
+    TaskGraph::TaskId TaskGraph::add(JobSystem::Task task, const std::initializer_list<TaskId> dependencies) {
+        const TaskId id = m_nodes.size();
+        for (const TaskId dependency : dependencies) {
+            if (dependency >= id) {
+                throw std::runtime_error("Task graph dependency must be added before its dependent");
+            }
+        }
+
+        Node& node = m_nodes.emplace_back();
+        node.task = std::move(task);
+        for (const TaskId dependency : dependencies) {
+            m_nodes[dependency].successors.push_back(id);
+            ++node.dependency_count;
+        }
+        return id;
+    }
+
+    void TaskGraph::run(JobSystem& system) const {
+        // dependencies still unfinished per task, whoever finishes the last one schedules it
+        const auto remaining = std::make_unique<std::atomic<std::size_t>[]>(m_nodes.size());
+        for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+            remaining[i].store(m_nodes[i].dependency_count, std::memory_order_relaxed);
+        }
+
+        TaskGroup group(system);
+        std::function<void(TaskId)> schedule = [&](const TaskId id) {
+            group.run([&, id] {
+                const Node& node = m_nodes[id];
+                if (node.task) {
+                    node.task(); // on a throw the successors are never scheduled
+                }
+                for (const TaskId successor : node.successors) {
+                    if (remaining[successor].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                        schedule(successor);
+                    }
+                }
+            });
+        };
+        for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+            if (m_nodes[i].dependency_count == 0) {
+                schedule(i);
+            }
+        }
+        group.wait();
+    }
+} // namespace di_renderer::jobs
@@ -0,0 +1,35 @@
+#pragma once
+#include "JobSystem.hpp"
+
+#include <cstddef>
+#include <initializer_list>
+#include <vector>
+
+namespace di_renderer::jobs {
+    // Tasks with dependencies, run on a JobSystem as soon as everything they depend on has finished.
+    // Dependencies can only name tasks added before, so a graph can never contain a cycle.
+    class TaskGraph final {
+      public:
+        using TaskId = std::size_t;
+
+        // Throws std::runtime_error for a dependency that isn't an earlier task
+        TaskId add(JobSystem::Task task, std::initializer_list<TaskId> dependencies = {});
+
+        std::size_t size() const noexcept {
+            return m_nodes.size();
+        }
+
+        // Runs every task once and returns when all are done. Tasks depending on one that threw are skipped,
+        // the others still run, then the first exception is rethrown. A graph can be run again.
+        void run(JobSystem& system) const;
+
+      private:
+        struct Node {
+            JobSystem::Task task;
+            std::vector<TaskId> successors;
+            std::size_t dependency_count = 0;
+        };
+
+        std::vector<Node> m_nodes;
+    };
+} // namespace di_renderer::jobs
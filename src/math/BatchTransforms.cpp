@@ -0,0 +1,161 @@
+#include "BatchTransforms.hpp"
+
+#include "Simd.hpp"
+#include "jobs/JobSystem.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <limits>
+#include <vector>
+
+namespace di_renderer::math {
+    namespace {
+        // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+        // Splits [0, count) into at most thread_count ranges on the shared job system and runs body(begin, end) on
+        // each, or runs it once over everything when thread_count is 1
+        template <typename Body>
+        void run_split(const std::size_t count, const std::size_t thread_count, const Body& body) {
+            if (thread_count == 1) {
+                body(0, count);
+                return;
+            }
+            jobs::JobSystem::global().parallel_for(count, BatchTransforms::MIN_PARALLEL_CHUNK_SIZE, body, thread_count);
+        }
+
+        // Same as run_split, returning the per-range results in order, at least one
+        template <typename Body>
+        auto map_split(const std::size_t count, const std::size_t thread_count, const Body& body) {
+            using Result = decltype(body(std::size_t{0}, std::size_t{0}));
+            if (thread_count == 1 || count == 0) {
+                return std::vector<Result>{body(0, count)};
+            }
+            return jobs::JobSystem::global().parallel_map(count, BatchTransforms::MIN_PARALLEL_CHUNK_SIZE, body,
+                                                          thread_count);
+        }
+
+#ifdef DI_RENDERER_SSE
+        struct Columns {
+            __m128 c0;
+            __m128 c1;
+            __m128 c2;
+            __m128 c3;
+
+            explicit Columns(const Matrix4x4& matrix)
+                : c0(_mm_loadu_ps(matrix.data())), c1(_mm_loadu_ps(matrix.data() + 4)),
+                  c2(_mm_loadu_ps(matrix.data() + 8)), c3(_mm_loadu_ps(matrix.data() + 12)) {}
+
+            // same summation order as Matrix4x4 * Vector4, the w = 1 term adds the translation column as-is
+            __m128 point(const Vector3& p) const noexcept {
+                return _mm_add_ps(direction(p), c3);
+            }
+            __m128 direction(const Vector3& d) const noexcept {
+                __m128 sum = _mm_mul_ps(c0, _mm_set1_ps(d.x));
+                sum = _mm_add_ps(sum, _mm_mul_ps(c1, _mm_set1_ps(d.y)));
+                return _mm_add_ps(sum, _mm_mul_ps(c2, _mm_set1_ps(d.z)));
+            }
+        };
+
+        // writes exactly three floats, so neighbouring elements of out are never touched
+        void store(Vector3& out, const __m128 value) noexcept {
+            _mm_storel_pi(reinterpret_cast<__m64*>(&out.x), value); // NOLINT(*-reinterpret-cast)
+            _mm_store_ss(&out.z, _mm_movehl_ps(value, value));
+        }
+#else
+        struct Columns {
+            const float* m;
+
+            explicit Columns(const Matrix4x4& matrix) : m(matrix.data()) {}
+
+            Vector3 point(const Vector3& p) const noexcept {
+                const Vector3 d = direction(p);
+                return {d.x + m[12], d.y + m[13], d.z + m[14]};
+            }
+            Vector3 direction(const Vector3& d) const noexcept {
+                return {(m[0] * d.x) + (m[4] * d.y) + (m[8] * d.z), (m[1] * d.x) + (m[5] * d.y) + (m[9] * d.z),
+                        (m[2] * d.x) + (m[6] * d.y) + (m[10] * d.z)};
+            }
+        };
+
+        void store(Vector3& out, const Vector3& value) noexcept {
+            out = value;
+        }
+#endif
+
+        void normalize(Vector3& v) noexcept {
+            const float length = std::sqrt((v.x * v.x) + (v.y * v.y) + (v.z * v.z));
+            if (length > std::numeric_limits<float>::epsilon()) {
+                v.x /= length;
+                v.y /= length;
+                v.z /= length;
+            }
+        }
+
+        // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+    } // namespace
+
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+    void BatchTransforms::transform_points(const Matrix4x4& matrix, const Vector3* points, Vector3* out,
+                                           const std::size_t count, const std::size_t thread_count) {
+        const Columns columns(matrix);
+        run_split(count, thread_count, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                store(out[i], columns.point(points[i]));
+            }
+        });
+    }
+
+    void BatchTransforms::transform_normals(const Matrix4x4& normal_matrix, const Vector3* normals, Vector3* out,
+                                            const std::size_t count, const std::size_t thread_count) {
+        const Columns columns(normal_matrix);
+        run_split(count, thread_count, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                store(out[i], columns.direction(normals[i]));
+                normalize(out[i]);
+            }
+        });
+    }
+
+    std::pair<Vector3, Vector3> BatchTransforms::transformed_bounds(const Matrix4x4& matrix, const Vector3* points,
+                                                                     const std::size_t count,
+                                                                     const std::size_t thread_count) {
+        constexpr float MAX = std::numeric_limits<float>::max();
+        const Columns columns(matrix);
+        const auto chunks = map_split(count, thread_count, [&](const std::size_t begin, const std::size_t end) {
+            std::pair<Vector3, Vector3> bounds{{MAX, MAX, MAX}, {-MAX, -MAX, -MAX}};
+#ifdef DI_RENDERER_SSE
+            __m128 min = _mm_set1_ps(MAX);
+            __m128 max = _mm_set1_ps(-MAX);
+            for (std::size_t i = begin; i < end; ++i) {
+                const __m128 p = columns.point(points[i]);
+                min = _mm_min_ps(min, p);
+                max = _mm_max_ps(max, p);
+            }
+            store(bounds.first, min);
+            store(bounds.second, max);
+#else
+            for (std::size_t i = begin; i < end; ++i) {
+                const Vector3 p = columns.point(points[i]);
+                bounds.first = {std::min(bounds.first.x, p.x), std::min(bounds.first.y, p.y),
+                                std::min(bounds.first.z, p.z)};
+                bounds.second = {std::max(bounds.second.x, p.x), std::max(bounds.second.y, p.y),
+                                 std::max(bounds.second.z, p.z)};
+            }
+#endif
+            return bounds;
+        });
+
+        std::pair<Vector3, Vector3> bounds = chunks.front();
+        for (const auto& [min, max] : chunks) {
+            bounds.first = {std::min(bounds.first.x, min.x), std::min(bounds.first.y, min.y),
+                            std::min(bounds.first.z, min.z)};
+            bounds.second = {std::max(bounds.second.x, max.x), std::max(bounds.second.y, max.y),
+                             std::max(bounds.second.z, max.z)};
+        }
+        return bounds;
+    }
+
+    // NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+} // namespace di_renderer::math
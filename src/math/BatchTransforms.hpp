@@ -0,0 +1,32 @@
+#pragma once
+
+#include "Matrix4x4.hpp"
+#include "Vector3.hpp"
+
+#include <cstddef>
+#include <utility>
+
+namespace di_renderer::math {
+    // Applies one matrix to a whole array of vectors: the matrix columns stay in SIMD registers for the entire
+    // pass and large arrays are split across the shared job system.
+    //
+    // thread_count 1 keeps the work on the calling thread, 0 uses the whole job system and any other value caps
+    // the number of ranges run in parallel. Ranges are never shorter than MIN_PARALLEL_CHUNK_SIZE. out may be the
+    // same array as the input.
+    class BatchTransforms {
+      public:
+        static constexpr std::size_t MIN_PARALLEL_CHUNK_SIZE = std::size_t{1} << 16U;
+
+        // Positions, w = 1. Gives the same results as matrix * Vector4(p, 1).
+        static void transform_points(const Matrix4x4& matrix, const Vector3* points, Vector3* out, std::size_t count,
+                                     std::size_t thread_count = 1);
+        // Normals through the upper 3x3 of normal_matrix (see Transform::get_normal_matrix), renormalized.
+        // Zero-length results are left as they are.
+        static void transform_normals(const Matrix4x4& normal_matrix, const Vector3* normals, Vector3* out,
+                                      std::size_t count, std::size_t thread_count = 1);
+        // Axis-aligned {min, max} of the transformed positions without storing them. An empty array gives
+        // {+max float, -max float}.
+        static std::pair<Vector3, Vector3> transformed_bounds(const Matrix4x4& matrix, const Vector3* points,
+                                                              std::size_t count, std::size_t thread_count = 1);
+    };
+} // namespace di_renderer::math
@@ -0,0 +1,65 @@
+#include "BoundingBox.hpp"
+
+#include "BatchTransforms.hpp"
+#include "jobs/JobSystem.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace di_renderer::math {
+    BoundingBox BoundingBox::from_points(const Vector3* points, const std::size_t count) {
+        // plain min/max over the coordinates, running them through a matrix would turn infinities into NaN
+        const auto chunks = jobs::JobSystem::global().parallel_map(
+            count, BatchTransforms::MIN_PARALLEL_CHUNK_SIZE, [points](const std::size_t begin, const std::size_t end) {
+                BoundingBox box;
+                for (std::size_t i = begin; i < end; ++i) {
+                    box.expand(points[i]); // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+                }
+                return box;
+            });
+        BoundingBox box;
+        for (const auto& chunk : chunks) {
+            box.expand(chunk);
+        }
+        return box;
+    }
+
+    Vector3 BoundingBox::get_center() const noexcept {
+        return {(min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f};
+    }
+
+    Vector3 BoundingBox::get_size() const noexcept {
+        return {max.x - min.x, max.y - min.y, max.z - min.z};
+    }
+
+    void BoundingBox::expand(const Vector3& point) noexcept {
+        min = {std::min(min.x, point.x), std::min(min.y, point.y), std::min(min.z, point.z)};
+        max = {std::max(max.x, point.x), std::max(max.y, point.y), std::max(max.z, point.z)};
+    }
+
+    void BoundingBox::expand(const BoundingBox& other) noexcept {
+        min = {std::min(min.x, other.min.x), std::min(min.y, other.min.y), std::min(min.z, other.min.z)};
+        max = {std::max(max.x, other.max.x), std::max(max.y, other.max.y), std::max(max.z, other.max.z)};
+    }
+
+    BoundingBox BoundingBox::transformed(const Matrix4x4& matrix) const noexcept {
+        if (is_empty()) {
+            return {};
+        }
+
+        const Vector3 center = get_center();
+        const Vector3 extents = get_size() * 0.5f;
+        const auto row = [&](const std::size_t i) {
+            const float moved_center = (matrix(i, 0) * center.x) + (matrix(i, 1) * center.y) +
+                                       (matrix(i, 2) * center.z) + matrix(i, 3);
+            const float extent = (std::abs(matrix(i, 0)) * extents.x) + (std::abs(matrix(i, 1)) * extents.y) +
+                                 (std::abs(matrix(i, 2)) * extents.z);
+            return std::pair{moved_center - extent, moved_center + extent};
+        };
+        const auto [min_x, max_x] = row(0);
+        const auto [min_y, max_y] = row(1);
+        const auto [min_z, max_z] = row(2);
+        return {{min_x, min_y, min_z}, {max_x, max_y, max_z}};
+    }
+} // namespace di_renderer::math
@@ -0,0 +1,38 @@
+#pragma once
+
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+
+#include <cstddef>
+#include <limits>
+
+namespace di_renderer::math {
+    // Axis-aligned box. The default one is empty: min above max on every axis, so expanding it by anything yields
+    // exactly that.
+    class BoundingBox {
+      public:
+        Vector3 min{std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                    std::numeric_limits<float>::max()};
+        Vector3 max{-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                    -std::numeric_limits<float>::max()};
+
+        BoundingBox() = default;
+        BoundingBox(const Vector3& min, const Vector3& max) noexcept : min(min), max(max) {}
+
+        // Bounds of an array of points, split across the job system for large arrays
+        static BoundingBox from_points(const Vector3* points, std::size_t count);
+
+        bool is_empty() const noexcept {
+            return min.x > max.x || min.y > max.y || min.z > max.z;
+        }
+        Vector3 get_center() const noexcept;
+        Vector3 get_size() const noexcept;
+
+        void expand(const Vector3& point) noexcept;
+        void expand(const BoundingBox& other) noexcept;
+
+        // Smallest axis-aligned box around this one moved through matrix (affine). Computed from the center and
+        // half extents, |matrix| * extents, so it costs the same as transforming two points instead of eight.
+        BoundingBox transformed(const Matrix4x4& matrix) const noexcept;
+    };
+} // namespace di_renderer::math
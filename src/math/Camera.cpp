@@ -3,6 +3,7 @@
 #include "math/MatrixTransforms.hpp"
 
 #include <algorithm>
+#include <atomic>
 #include <cmath>
 
 namespace di_renderer::math {
@@ -24,28 +25,44 @@ namespace di_renderer::math {
     void Camera::set_position(const Vector3& position) {
         m_position = position;
         update_euler_from_vectors();
+        mark_view_dirty();
     }
 
     void Camera::set_target(const Vector3& target) {
         m_target = target;
         update_euler_from_vectors();
+        mark_view_dirty();
     }
 
     void Camera::set_up_vector(const Vector3& up) {
         m_up = up;
+        mark_view_dirty();
     }
 
+    // the renderer sets planes and aspect ratio every frame, unchanged values must not invalidate anything
     void Camera::set_planes(const float near_plane, const float far_plane) {
+        if (m_near_plane == near_plane && m_far_plane == far_plane) {
+            return;
+        }
         m_near_plane = near_plane;
         m_far_plane = far_plane;
+        mark_projection_dirty();
     }
 
     void Camera::set_fov(const float fov) {
+        if (m_fov == fov) {
+            return;
+        }
         m_fov = fov;
+        mark_projection_dirty();
     }
 
     void Camera::set_aspect_ratio(const float aspect_ratio) {
+        if (m_aspect_ratio == aspect_ratio) {
+            return;
+        }
         m_aspect_ratio = aspect_ratio;
+        mark_projection_dirty();
     }
 
     const Vector3& Camera::get_position() const {
@@ -63,11 +80,13 @@ namespace di_renderer::math {
     void Camera::move_position(const Vector3& position) {
         m_position += position;
         m_distance_to_target = (m_target - m_position).length();
+        mark_view_dirty();
     }
 
     void Camera::move_target(const Vector3& target) {
         m_target += target;
         update_euler_from_vectors();
+        mark_view_dirty();
     }
 
     void Camera::move(const Vector3& direction) {
@@ -82,6 +101,7 @@ namespace di_renderer::math {
         m_position += world_direction;
         m_target += world_direction;
         m_distance_to_target = (m_target - m_position).length();
+        mark_view_dirty();
     }
 
     void Camera::rotate_view(float dx, float dy) {
@@ -106,6 +126,53 @@ namespace di_renderer::math {
         }
         m_position += move_vector;
         m_distance_to_target -= zoom_amount;
+        mark_view_dirty();
+    }
+
+    void Camera::fit_to_bounds(const BoundingBox& bounds) {
+        const Vector3 center = bounds.get_center();
+        const Vector3 size = bounds.get_size();
+        const float model_radius = std::max({size.x, size.y, size.z}) * 0.5f;
+
+        // always framed for a 45 degree view, whatever the current field of view
+        const float fit_fov = 45.0f * static_cast<float>(M_PI) / 180.0f;
+        const float distance = std::clamp(model_radius / std::tan(fit_fov / 2.0f) * 1.5f, 1.0f, 500.0f);
+
+        set_position(Vector3(center.x, center.y, center.z + distance));
+        set_target(center);
+        fit_planes_to_bounds(bounds, distance);
+    }
+
+    void Camera::fit_planes_to_bounds(const BoundingBox& bounds, const float distance) {
+        const Vector3 size = bounds.get_size();
+        const float max_dimension = std::max({size.x, size.y, size.z});
+
+        float near_plane = 0.1f;
+        float far_plane = 100.0f;
+
+        if (max_dimension < 1.0f) {
+            near_plane = std::max(0.01f, distance * 0.01f);
+            far_plane = (distance * 5.0f) + (max_dimension * 10.0f);
+        } else if (max_dimension < 10.0f) {
+            near_plane = std::max(0.1f, distance * 0.05f);
+            far_plane = (distance * 10.0f) + (max_dimension * 10.0f);
+        } else if (max_dimension < 100.0f) {
+            near_plane = std::max(0.5f, distance * 0.1f);
+            far_plane = (distance * 20.0f) + (max_dimension * 10.0f);
+        } else {
+            near_plane = std::max(1.0f, distance * 0.2f);
+            far_plane = (distance * 50.0f) + (max_dimension * 10.0f);
+        }
+
+        const float min_far_plane = 1000.0f;
+        far_plane = std::max(far_plane, min_far_plane);
+
+        const float max_ratio = 10000.0f;
+        if (far_plane / near_plane > max_ratio) {
+            near_plane = far_plane / max_ratio;
+        }
+
+        set_planes(near_plane, far_plane);
     }
 
     void Camera::update_euler_from_vectors() {
@@ -132,13 +199,52 @@ namespace di_renderer::math {
         } else {
             m_target = m_position + (front * m_distance_to_target);
         }
+        mark_view_dirty();
+    }
+
+    const Matrix4x4& Camera::get_view_matrix() const {
+        if (m_view_dirty) {
+            m_view_matrix = MatrixTransforms::look_at(m_position, m_target, m_up);
+            m_view_dirty = false;
+        }
+        return m_view_matrix;
+    }
+
+    const Matrix4x4& Camera::get_projection_matrix() const {
+        if (m_projection_dirty) {
+            m_projection_matrix = MatrixTransforms::perspective(m_fov, m_aspect_ratio, m_near_plane, m_far_plane);
+            m_projection_dirty = false;
+        }
+        return m_projection_matrix;
     }
-    Matrix4x4 Camera::get_view_matrix() const {
-        return MatrixTransforms::look_at(m_position, m_target, m_up);
+
+    const Matrix4x4& Camera::get_view_projection_matrix() const {
+        if (m_view_projection_dirty) {
+            m_view_projection_matrix = get_projection_matrix() * get_view_matrix();
+            m_view_projection_dirty = false;
+        }
+        return m_view_projection_matrix;
+    }
+
+    std::uint64_t Camera::get_version() const noexcept {
+        return m_version;
+    }
+
+    void Camera::mark_view_dirty() noexcept {
+        m_view_dirty = true;
+        m_view_projection_dirty = true;
+        m_version = next_version();
+    }
+
+    void Camera::mark_projection_dirty() noexcept {
+        m_projection_dirty = true;
+        m_view_projection_dirty = true;
+        m_version = next_version();
     }
 
-    Matrix4x4 Camera::get_projection_matrix() const {
-        return MatrixTransforms::perspective(m_fov, m_aspect_ratio, m_near_plane, m_far_plane);
+    std::uint64_t Camera::next_version() noexcept {
+        static std::atomic<std::uint64_t> next{1};
+        return next.fetch_add(1, std::memory_order_relaxed);
     }
 
 } // namespace di_renderer::math
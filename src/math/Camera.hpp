@@ -1,7 +1,10 @@
 #pragma once
+#include "math/BoundingBox.hpp"
 #include "math/Matrix4x4.hpp"
 #include "math/Vector3.hpp"
 
+#include <cstdint>
+
 namespace di_renderer::math {
     class Camera {
       public:
@@ -33,13 +36,30 @@ namespace di_renderer::math {
 
         void zoom(float offset);
 
-        Matrix4x4 get_view_matrix() const;
-        Matrix4x4 get_projection_matrix() const;
+        // Looks at bounds from +Z, far enough to have all of it in view, and fits the clip planes to it
+        void fit_to_bounds(const BoundingBox& bounds);
+        // Clip planes for viewing bounds from distance, with the far/near ratio kept at most 10000
+        void fit_planes_to_bounds(const BoundingBox& bounds, float distance);
+
+        // Cached, rebuilt on the first query after a change. Concurrent const calls are not safe.
+        const Matrix4x4& get_view_matrix() const;
+        const Matrix4x4& get_projection_matrix() const;
+        // projection * view
+        const Matrix4x4& get_view_projection_matrix() const;
+
+        // Changes whenever the matrices do and is never reused, also not by another camera, so comparing it with
+        // a stored value tells whether anything derived from this camera must be recomputed.
+        // Setting a value equal to the current one keeps it.
+        std::uint64_t get_version() const noexcept;
 
       private:
         void update_euler_from_vectors();
         void update_vectors_from_euler(bool is_orbiting);
 
+        void mark_view_dirty() noexcept;
+        void mark_projection_dirty() noexcept;
+        static std::uint64_t next_version() noexcept;
+
         Vector3 m_position;
         Vector3 m_target;
         Vector3 m_up{0.0f, 1.0f, 0.0f};
@@ -55,6 +75,14 @@ namespace di_renderer::math {
         float m_aspect_ratio;
         float m_near_plane;
         float m_far_plane;
+
+        std::uint64_t m_version = next_version();
+        mutable Matrix4x4 m_view_matrix;
+        mutable Matrix4x4 m_projection_matrix;
+        mutable Matrix4x4 m_view_projection_matrix;
+        mutable bool m_view_dirty = true;
+        mutable bool m_projection_dirty = true;
+        mutable bool m_view_projection_dirty = true;
     };
 
 } // namespace di_renderer::math
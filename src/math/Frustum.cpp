@@ -0,0 +1,51 @@
+#include "Frustum.hpp"
+
+#include <cmath>
+#include <cstddef>
+
+namespace di_renderer::math {
+    Frustum::Frustum(const Matrix4x4& view_projection) noexcept {
+        // a point is inside when -w <= x, y, z <= w in clip space, which makes every plane a sum or difference
+        // of the w row and one of the others
+        const auto row = [&](const std::size_t i) {
+            return std::array<float, 4>{view_projection(i, 0), view_projection(i, 1), view_projection(i, 2),
+                                        view_projection(i, 3)};
+        };
+        const std::array<float, 4> w = row(3);
+        for (std::size_t axis = 0; axis < 3; ++axis) {
+            const std::array<float, 4> r = row(axis);
+            for (std::size_t side = 0; side < 2; ++side) {
+                const float sign = side == 0 ? 1.0f : -1.0f;
+                const Vector3 normal(w[0] + (sign * r[0]), w[1] + (sign * r[1]), w[2] + (sign * r[2]));
+                const float length = normal.length();
+                const float scale = length > 0.0f ? 1.0f / length : 0.0f;
+                m_planes.at((axis * 2) + side) = {normal * scale, (w[3] + (sign * r[3])) * scale};
+            }
+        }
+    }
+
+    bool Frustum::intersects_sphere(const Vector3& center, const float radius) const noexcept {
+        for (const Plane& plane : m_planes) {
+            if (plane.normal.dot(center) + plane.distance < -radius) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool Frustum::intersects(const BoundingBox& box) const noexcept {
+        if (box.is_empty()) {
+            return false;
+        }
+        for (const Plane& plane : m_planes) {
+            // the corner furthest along the normal, if even that one is behind the plane the whole box is
+            const Vector3 corner(plane.normal.x >= 0.0f ? box.max.x : box.min.x,
+                                 plane.normal.y >= 0.0f ? box.max.y : box.min.y,
+                                 plane.normal.z >= 0.0f ? box.max.z : box.min.z);
+            if (plane.normal.dot(corner) + plane.distance < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+} // namespace di_renderer::math
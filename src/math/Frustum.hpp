@@ -0,0 +1,36 @@
+#pragma once
+
+#include "math/BoundingBox.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+
+#include <array>
+
+namespace di_renderer::math {
+    // The six clip planes of a view-projection matrix, in world space when the matrix is projection * view.
+    // Tests are conservative: anything they report outside is invisible, a few invisible boxes near the frustum
+    // corners are reported inside.
+    class Frustum {
+      public:
+        // Plane a*x + b*y + c*z + d = 0 with (a, b, c) of unit length pointing into the frustum
+        struct Plane {
+            Vector3 normal;
+            float distance = 0.0f;
+        };
+
+        Frustum() = default;
+        // Planes extracted from the rows of an OpenGL style matrix (clip depth in [-w, w])
+        explicit Frustum(const Matrix4x4& view_projection) noexcept;
+
+        const std::array<Plane, 6>& get_planes() const noexcept {
+            return m_planes;
+        }
+
+        bool intersects_sphere(const Vector3& center, float radius) const noexcept;
+        // Empty boxes never intersect
+        bool intersects(const BoundingBox& box) const noexcept;
+
+      private:
+        std::array<Plane, 6> m_planes{};
+    };
+} // namespace di_renderer::math
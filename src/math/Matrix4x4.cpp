@@ -1,157 +1,177 @@
 #include "Matrix4x4.hpp"
 
+#include "Simd.hpp"
+
 #include <array>
 #include <cmath>
 #include <limits>
-#include <stdexcept>
 
 namespace di_renderer::math {
-    Matrix4x4::Matrix4x4() {
-        m_data.fill(0.0f);
-    }
-
-    Matrix4x4::Matrix4x4(const std::array<float, 16>& values) : m_data(values) {}
+    // The kernels below work on m_data directly, one column is four contiguous floats and fits an SSE register
+    // NOLINTBEGIN(cppcoreguidelines-pro-bounds-constant-array-index)
 
-    Matrix4x4::Matrix4x4(const std::function<float(int, int)>& func) {
-        for (int col = 0; col < 4; col++) {
-            for (int row = 0; row < 4; row++) {
-                (*this)(row, col) = func(row, col);
+    Matrix4x4 Matrix4x4::transposed() const noexcept {
+        Matrix4x4 result;
+#ifdef DI_RENDERER_SSE
+        __m128 col0 = _mm_loadu_ps(&m_data[0]);
+        __m128 col1 = _mm_loadu_ps(&m_data[4]);
+        __m128 col2 = _mm_loadu_ps(&m_data[8]);
+        __m128 col3 = _mm_loadu_ps(&m_data[12]);
+        _MM_TRANSPOSE4_PS(col0, col1, col2, col3);
+        _mm_storeu_ps(&result.m_data[0], col0);
+        _mm_storeu_ps(&result.m_data[4], col1);
+        _mm_storeu_ps(&result.m_data[8], col2);
+        _mm_storeu_ps(&result.m_data[12], col3);
+#else
+        for (size_t col = 0; col < 4; ++col) {
+            for (size_t row = 0; row < 4; ++row) {
+                result.m_data[(col * 4) + row] = m_data[(row * 4) + col];
             }
         }
+#endif
+        return result;
     }
 
-    const float* Matrix4x4::data() const {
-        return m_data.data();
-    }
-
-    Matrix4x4 Matrix4x4::identity() {
-        return Matrix4x4([](int row, int col) { return row == col ? 1.0f : 0.0f; });
-    }
-
-    Matrix4x4 Matrix4x4::transposed() const {
-        return Matrix4x4([this](int row, int col) { return (*this)(col, row); }); // NOLINT
-    }
-
-    float Matrix4x4::operator()(const size_t row, const size_t col) const {
-        if (row >= 4 || col >= 4) {
-            throw std::out_of_range("Couldn't get matrix element, parameters must be 0 < {par, par} < 4");
+    Matrix4x4 Matrix4x4::operator+(const Matrix4x4& other) const noexcept {
+        Matrix4x4 result;
+#ifdef DI_RENDERER_SSE
+        for (size_t i = 0; i < 16; i += 4) {
+            _mm_storeu_ps(&result.m_data[i], _mm_add_ps(_mm_loadu_ps(&m_data[i]), _mm_loadu_ps(&other.m_data[i])));
         }
-        return m_data[(col * 4) + row]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    }
-
-    float& Matrix4x4::operator()(const size_t row, const size_t col) {
-        if (row >= 4 || col >= 4) {
-            throw std::out_of_range("Couldn't set matrix element,parameters must be 0 < (par, par) < 4");
+#else
+        for (size_t i = 0; i < 16; ++i) {
+            result.m_data[i] = m_data[i] + other.m_data[i];
         }
-        return m_data[(col * 4) + row]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
-    }
-
-    Matrix4x4 Matrix4x4::operator+(const Matrix4x4& other) const {
-        return Matrix4x4([this, &other](int row, int col) { return (*this)(row, col) + other(row, col); });
+#endif
+        return result;
     }
 
-    Matrix4x4 Matrix4x4::operator-(const Matrix4x4& other) const {
-        return Matrix4x4([this, &other](int row, int col) { return (*this)(row, col) - other(row, col); });
+    Matrix4x4 Matrix4x4::operator-(const Matrix4x4& other) const noexcept {
+        Matrix4x4 result;
+#ifdef DI_RENDERER_SSE
+        for (size_t i = 0; i < 16; i += 4) {
+            _mm_storeu_ps(&result.m_data[i], _mm_sub_ps(_mm_loadu_ps(&m_data[i]), _mm_loadu_ps(&other.m_data[i])));
+        }
+#else
+        for (size_t i = 0; i < 16; ++i) {
+            result.m_data[i] = m_data[i] - other.m_data[i];
+        }
+#endif
+        return result;
     }
 
-    Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const {
-        return Matrix4x4([this, &other](int row, int col) {
-            float result = 0;
-            for (int k = 0; k < 4; k++) {
-                result += (*this)(row, k) * other(k, col);
+    Matrix4x4 Matrix4x4::operator*(const Matrix4x4& other) const noexcept {
+        // column j of the product is this matrix applied to column j of other. Both paths add the four
+        // products in the same order, so they give identical results.
+        Matrix4x4 result;
+#ifdef DI_RENDERER_SSE
+        const __m128 col0 = _mm_loadu_ps(&m_data[0]);
+        const __m128 col1 = _mm_loadu_ps(&m_data[4]);
+        const __m128 col2 = _mm_loadu_ps(&m_data[8]);
+        const __m128 col3 = _mm_loadu_ps(&m_data[12]);
+        for (size_t col = 0; col < 16; col += 4) {
+            __m128 sum = _mm_mul_ps(col0, _mm_set1_ps(other.m_data[col]));
+            sum = _mm_add_ps(sum, _mm_mul_ps(col1, _mm_set1_ps(other.m_data[col + 1])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(col2, _mm_set1_ps(other.m_data[col + 2])));
+            sum = _mm_add_ps(sum, _mm_mul_ps(col3, _mm_set1_ps(other.m_data[col + 3])));
+            _mm_storeu_ps(&result.m_data[col], sum);
+        }
+#else
+        for (size_t col = 0; col < 16; col += 4) {
+            for (size_t row = 0; row < 4; ++row) {
+                result.m_data[col + row] =
+                    (m_data[row] * other.m_data[col]) + (m_data[4 + row] * other.m_data[col + 1]) +
+                    (m_data[8 + row] * other.m_data[col + 2]) + (m_data[12 + row] * other.m_data[col + 3]);
             }
-            return result;
-        });
+        }
+#endif
+        return result;
     }
 
-    Vector4 Matrix4x4::operator*(const Vector4& vec) const {
-        return {((*this)(0, 0) * vec.x) + ((*this)(0, 1) * vec.y) + ((*this)(0, 2) * vec.z) + ((*this)(0, 3) * vec.w),
-                ((*this)(1, 0) * vec.x) + ((*this)(1, 1) * vec.y) + ((*this)(1, 2) * vec.z) + ((*this)(1, 3) * vec.w),
-                ((*this)(2, 0) * vec.x) + ((*this)(2, 1) * vec.y) + ((*this)(2, 2) * vec.z) + ((*this)(2, 3) * vec.w),
-                ((*this)(3, 0) * vec.x) + ((*this)(3, 1) * vec.y) + ((*this)(3, 2) * vec.z) + ((*this)(3, 3) * vec.w)};
+    Vector4 Matrix4x4::operator*(const Vector4& vec) const noexcept {
+        // no SSE path here, one measured no faster than these scalar sums
+        return {(m_data[0] * vec.x) + (m_data[4] * vec.y) + (m_data[8] * vec.z) + (m_data[12] * vec.w),
+                (m_data[1] * vec.x) + (m_data[5] * vec.y) + (m_data[9] * vec.z) + (m_data[13] * vec.w),
+                (m_data[2] * vec.x) + (m_data[6] * vec.y) + (m_data[10] * vec.z) + (m_data[14] * vec.w),
+                (m_data[3] * vec.x) + (m_data[7] * vec.y) + (m_data[11] * vec.z) + (m_data[15] * vec.w)};
     }
 
-    Matrix4x4& Matrix4x4::operator+=(const Matrix4x4& other) {
+    Matrix4x4& Matrix4x4::operator+=(const Matrix4x4& other) noexcept {
         *this = *this + other;
         return *this;
     }
 
-    Matrix4x4& Matrix4x4::operator-=(const Matrix4x4& other) {
+    Matrix4x4& Matrix4x4::operator-=(const Matrix4x4& other) noexcept {
         *this = *this - other;
         return *this;
     }
 
-    Matrix4x4& Matrix4x4::operator*=(const Matrix4x4& other) {
+    Matrix4x4& Matrix4x4::operator*=(const Matrix4x4& other) noexcept {
         *this = *this * other;
         return *this;
     }
 
-    bool Matrix4x4::operator==(const Matrix4x4& other) const {
-        for (size_t row = 0; row < 4; ++row) {
-            for (size_t col = 0; col < 4; ++col) {
-                if (std::abs((*this)(row, col) - other(row, col)) > std::numeric_limits<float>::epsilon()) {
-                    return false;
-                }
+    bool Matrix4x4::operator==(const Matrix4x4& other) const noexcept {
+        for (size_t i = 0; i < 16; ++i) {
+            if (std::abs(m_data[i] - other.m_data[i]) > std::numeric_limits<float>::epsilon()) {
+                return false;
             }
         }
         return true;
     }
 
-    float Matrix4x4::calculate_determinant_3x3(float m00, float m01, float m02, float m10, float m11, float m12,
-                                               float m20, float m21, float m22) {
-        return (m00 * (m11 * m22 - m12 * m21)) - (m01 * (m10 * m22 - m12 * m20)) + (m02 * (m10 * m21 - m11 * m20));
+    Matrix4x4::Minors Matrix4x4::get_minors() const noexcept {
+        // 2x2 determinants of the top two and bottom two rows, shared by every cofactor (Laplace expansion)
+        const std::array<float, 16>& m = m_data;
+        return {{(m[0] * m[5]) - (m[1] * m[4]), (m[0] * m[9]) - (m[1] * m[8]), (m[0] * m[13]) - (m[1] * m[12]),
+                 (m[4] * m[9]) - (m[5] * m[8]), (m[4] * m[13]) - (m[5] * m[12]), (m[8] * m[13]) - (m[9] * m[12])},
+                {(m[2] * m[7]) - (m[3] * m[6]), (m[2] * m[11]) - (m[3] * m[10]), (m[2] * m[15]) - (m[3] * m[14]),
+                 (m[6] * m[11]) - (m[7] * m[10]), (m[6] * m[15]) - (m[7] * m[14]),
+                 (m[10] * m[15]) - (m[11] * m[14])}};
     }
 
-    float Matrix4x4::get_cofactor(int skip_row, int skip_col) const {
-        std::array<int, 3> rows = {};
-        std::array<int, 3> cols = {};
-
-        int k = 0;
-        for (int row = 0; row < 4; ++row) {
-            if (row != skip_row) {
-                rows[k++] = row; // NOLINT
-            }
-        }
-
-        k = 0;
-        for (int col = 0; col < 4; ++col) {
-            if (col != skip_col) {
-                cols[k++] = col; // NOLINT
-            }
-        }
-
-        const float det =
-            calculate_determinant_3x3((*this)(rows[0], cols[0]), (*this)(rows[0], cols[1]), (*this)(rows[0], cols[2]),
-                                      (*this)(rows[1], cols[0]), (*this)(rows[1], cols[1]), (*this)(rows[1], cols[2]),
-                                      (*this)(rows[2], cols[0]), (*this)(rows[2], cols[1]), (*this)(rows[2], cols[2]));
-
-        return ((skip_row + skip_col) % 2 == 0) ? det : -det;
+    float Matrix4x4::Minors::determinant() const noexcept {
+        return (top[0] * bottom[5]) - (top[1] * bottom[4]) + (top[2] * bottom[3]) + (top[3] * bottom[2]) -
+               (top[4] * bottom[1]) + (top[5] * bottom[0]);
     }
 
-    float Matrix4x4::determinant() const {
-        float det = 0.0f;
-        for (int col = 0; col < 4; ++col) {
-            det += (*this)(0, col) * Matrix4x4::get_cofactor(0, col);
-        }
-        return det;
+    float Matrix4x4::determinant() const noexcept {
+        return get_minors().determinant();
     }
 
-    Matrix4x4 Matrix4x4::inverse() const {
-        const float det = determinant();
+    Matrix4x4 Matrix4x4::inverse() const noexcept {
+        const Minors minors = get_minors();
+        const float det = minors.determinant();
 
         if (std::abs(det) < std::numeric_limits<float>::epsilon()) {
             return identity();
         }
 
         const float inv_det = 1.0f / det;
-        Matrix4x4 result;
-        for (int row = 0; row < 4; ++row) {
-            for (int col = 0; col < 4; ++col) {
-                const float cofactor = Matrix4x4::get_cofactor(row, col);
-                result(col, row) = cofactor * inv_det; // NOLINT
-            }
-        }
-        return result;
+        const std::array<float, 16>& m = m_data;
+        const std::array<float, 6>& s = minors.top;
+        const std::array<float, 6>& c = minors.bottom;
+        // adjugate, written out so the compiler can keep everything in registers
+        return Matrix4x4(std::array<float, 16>{
+            ((m[5] * c[5]) - (m[9] * c[4]) + (m[13] * c[3])) * inv_det,
+            ((-m[1] * c[5]) + (m[9] * c[2]) - (m[13] * c[1])) * inv_det,
+            ((m[1] * c[4]) - (m[5] * c[2]) + (m[13] * c[0])) * inv_det,
+            ((-m[1] * c[3]) + (m[5] * c[1]) - (m[9] * c[0])) * inv_det,
+            ((-m[4] * c[5]) + (m[8] * c[4]) - (m[12] * c[3])) * inv_det,
+            ((m[0] * c[5]) - (m[8] * c[2]) + (m[12] * c[1])) * inv_det,
+            ((-m[0] * c[4]) + (m[4] * c[2]) - (m[12] * c[0])) * inv_det,
+            ((m[0] * c[3]) - (m[4] * c[1]) + (m[8] * c[0])) * inv_det,
+            ((m[7] * s[5]) - (m[11] * s[4]) + (m[15] * s[3])) * inv_det,
+            ((-m[3] * s[5]) + (m[11] * s[2]) - (m[15] * s[1])) * inv_det,
+            ((m[3] * s[4]) - (m[7] * s[2]) + (m[15] * s[0])) * inv_det,
+            ((-m[3] * s[3]) + (m[7] * s[1]) - (m[11] * s[0])) * inv_det,
+            ((-m[6] * s[5]) + (m[10] * s[4]) - (m[14] * s[3])) * inv_det,
+            ((m[2] * s[5]) - (m[10] * s[2]) + (m[14] * s[1])) * inv_det,
+            ((-m[2] * s[4]) + (m[6] * s[2]) - (m[14] * s[0])) * inv_det,
+            ((m[2] * s[3]) - (m[6] * s[1]) + (m[10] * s[0])) * inv_det,
+        });
     }
 
+    // NOLINTEND(cppcoreguidelines-pro-bounds-constant-array-index)
+
 } // namespace di_renderer::math
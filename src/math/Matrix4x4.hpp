@@ -2,45 +2,72 @@
 #include "Vector4.hpp"
 
 #include <array>
-#include <functional>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
 
 namespace di_renderer::math {
+    // Column-major 4x4 matrix, element (row, col) is stored at col * 4 + row.
+    // Construction and element access are constexpr; indices are only checked (by assert) in debug builds.
     class Matrix4x4 {
       public:
-        Matrix4x4();
+        constexpr Matrix4x4() noexcept = default;
 
-        explicit Matrix4x4(const std::array<float, 16>& values);
+        constexpr explicit Matrix4x4(const std::array<float, 16>& values) noexcept : m_data(values) {}
 
-        explicit Matrix4x4(const std::function<float(int, int)>& func);
+        // Fills every element with func(row, col)
+        template <typename Func, typename = std::enable_if_t<std::is_invocable_r_v<float, const Func&, int, int>>>
+        constexpr explicit Matrix4x4(const Func& func) noexcept(std::is_nothrow_invocable_v<const Func&, int, int>) {
+            for (int col = 0; col < 4; col++) {
+                for (int row = 0; row < 4; row++) {
+                    (*this)(row, col) = func(row, col);
+                }
+            }
+        }
 
-        const float* data() const;
+        constexpr const float* data() const noexcept {
+            return m_data.data();
+        }
 
-        static Matrix4x4 identity();
-        Matrix4x4 transposed() const;
+        static constexpr Matrix4x4 identity() noexcept {
+            return Matrix4x4(std::array<float, 16>{1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f,
+                                                   0.0f, 0.0f, 0.0f, 0.0f, 1.0f});
+        }
+        Matrix4x4 transposed() const noexcept;
 
-        float determinant() const;
-        Matrix4x4 inverse() const;
+        float determinant() const noexcept;
+        Matrix4x4 inverse() const noexcept;
 
-        float& operator()(size_t row, size_t col);
-        float operator()(size_t row, size_t col) const;
+        constexpr float& operator()(const std::size_t row, const std::size_t col) noexcept {
+            assert(row < 4 && col < 4);
+            return m_data[(col * 4) + row]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
+        constexpr float operator()(const std::size_t row, const std::size_t col) const noexcept {
+            assert(row < 4 && col < 4);
+            return m_data[(col * 4) + row]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+        }
 
-        Matrix4x4 operator+(const Matrix4x4& other) const;
-        Matrix4x4 operator-(const Matrix4x4& other) const;
-        Matrix4x4 operator*(const Matrix4x4& other) const;
+        Matrix4x4 operator+(const Matrix4x4& other) const noexcept;
+        Matrix4x4 operator-(const Matrix4x4& other) const noexcept;
+        Matrix4x4 operator*(const Matrix4x4& other) const noexcept;
 
-        Matrix4x4& operator+=(const Matrix4x4& other);
-        Matrix4x4& operator-=(const Matrix4x4& other);
-        Matrix4x4& operator*=(const Matrix4x4& other);
+        Matrix4x4& operator+=(const Matrix4x4& other) noexcept;
+        Matrix4x4& operator-=(const Matrix4x4& other) noexcept;
+        Matrix4x4& operator*=(const Matrix4x4& other) noexcept;
 
-        Vector4 operator*(const Vector4& vec) const;
+        Vector4 operator*(const Vector4& vec) const noexcept;
 
-        bool operator==(const Matrix4x4& other) const;
+        bool operator==(const Matrix4x4& other) const noexcept;
 
       private:
         std::array<float, 16> m_data{};
-        inline static float calculate_determinant_3x3(float m00, float m01, float m02, float m10, float m11, float m12,
-                                                      float m20, float m21, float m22);
 
-        float get_cofactor(int skip_row, int skip_col) const;
+        struct Minors {
+            std::array<float, 6> top;
+            std::array<float, 6> bottom;
+
+            float determinant() const noexcept;
+        };
+        Minors get_minors() const noexcept;
     };
 } // namespace di_renderer::math
@@ -3,34 +3,6 @@
 #include <cmath>
 
 namespace di_renderer::math {
-    Matrix4x4 MatrixTransforms::translate(const Vector3& offset) {
-
-        // clang-format off
-        Matrix4x4 res({
-            1, 0, 0, 0,
-            0, 1, 0, 0,
-            0, 0, 1, 0,
-            offset.x, offset.y, offset.z, 1
-        });
-        // clang-format on
-
-        return res;
-    }
-
-    Matrix4x4 MatrixTransforms::scale(const Vector3& scale) {
-
-        // clang-format off
-        Matrix4x4 res({
-            scale.x, 0, 0, 0,
-            0, scale.y, 0, 0,
-            0, 0, scale.z, 0,
-            0, 0, 0, 1
-        });
-        // clang-format on
-
-        return res;
-    }
-
     Matrix4x4 MatrixTransforms::rotate_x(const float angle) {
         const float c = std::cos(angle);
         const float s = std::sin(angle);
@@ -6,9 +6,27 @@
 namespace di_renderer::math {
     class MatrixTransforms {
       public:
-        static Matrix4x4 translate(const Vector3& offset);
+        static constexpr Matrix4x4 translate(const Vector3& offset) noexcept {
+            // clang-format off
+            return Matrix4x4({
+                1, 0, 0, 0,
+                0, 1, 0, 0,
+                0, 0, 1, 0,
+                offset.x, offset.y, offset.z, 1
+            });
+            // clang-format on
+        }
 
-        static Matrix4x4 scale(const Vector3& scale);
+        static constexpr Matrix4x4 scale(const Vector3& scale) noexcept {
+            // clang-format off
+            return Matrix4x4({
+                scale.x, 0, 0, 0,
+                0, scale.y, 0, 0,
+                0, 0, scale.z, 0,
+                0, 0, 0, 1
+            });
+            // clang-format on
+        }
 
         static Matrix4x4 rotate_x(float angle);
         static Matrix4x4 rotate_y(float angle);
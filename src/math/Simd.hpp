@@ -0,0 +1,8 @@
+#pragma once
+
+// SSE is part of the x86-64 baseline, so no extra compiler flags are needed to enable it.
+// Define DI_RENDERER_NO_SIMD to build the portable scalar paths instead.
+#if !defined(DI_RENDERER_NO_SIMD) && (defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64))
+#define DI_RENDERER_SSE 1
+#include <xmmintrin.h>
+#endif
@@ -1,6 +1,9 @@
 #include "Transform.hpp"
 
-#include "math/MatrixTransforms.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <limits>
 
 namespace di_renderer::math {
     // rotation в радианах!
@@ -8,28 +11,34 @@ namespace di_renderer::math {
 
     void Transform::set_position(const math::Vector3& position) {
         m_translation = position;
+        m_dirty = true;
     }
 
     void Transform::set_rotation(const math::Vector3& rotation) {
         m_rotation = rotation;
+        m_dirty = true;
     }
 
     void Transform::set_scale(const math::Vector3& scale) {
         m_scale = scale;
+        m_dirty = true;
     }
 
     void Transform::translate(const math::Vector3& translation) {
         m_translation += translation;
+        m_dirty = true;
     }
 
     void Transform::scale(const math::Vector3& scale) {
         m_scale.x *= scale.x;
         m_scale.y *= scale.y;
         m_scale.z *= scale.z;
+        m_dirty = true;
     }
 
     void Transform::rotate(const math::Vector3& rotation) {
         m_rotation += rotation;
+        m_dirty = true;
     }
 
     const math::Vector3& Transform::get_position() const {
@@ -44,18 +53,68 @@ namespace di_renderer::math {
         return m_scale;
     }
 
-    math::Matrix4x4 Transform::get_matrix() const {
-
-        const auto t = math::MatrixTransforms::translate(m_translation);
-        const auto s = math::MatrixTransforms::scale(m_scale);
+    const math::Matrix4x4& Transform::get_matrix() const {
+        if (m_dirty) {
+            update_matrices();
+        }
+        return m_matrix;
+    }
 
-        const auto rx = math::MatrixTransforms::rotate_x(m_rotation.x);
-        const auto ry = math::MatrixTransforms::rotate_y(m_rotation.y);
-        const auto rz = math::MatrixTransforms::rotate_z(m_rotation.z);
+    const math::Matrix4x4& Transform::get_inverse_matrix() const {
+        if (m_dirty) {
+            update_matrices();
+        }
+        return m_inverse_matrix;
+    }
 
-        // Комбинация вращения
-        const auto r = rz * ry * rx;
+    const math::Matrix4x4& Transform::get_normal_matrix() const {
+        if (m_dirty) {
+            update_matrices();
+        }
+        return m_normal_matrix;
+    }
 
-        return t * r * s;
+    void Transform::update_matrices() const {
+        const float cx = std::cos(m_rotation.x);
+        const float sx = std::sin(m_rotation.x);
+        const float cy = std::cos(m_rotation.y);
+        const float sy = std::sin(m_rotation.y);
+        const float cz = std::cos(m_rotation.z);
+        const float sz = std::sin(m_rotation.z);
+
+        // Rz * Ry * Rx multiplied out, with MatrixTransforms::rotate_y's sign convention. Columns of R.
+        const std::array<Vector3, 3> r = {
+            Vector3(cz * cy, sz * cy, sy),
+            Vector3((-cz * sy * sx) - (sz * cx), (-sz * sy * sx) + (cz * cx), cy * sx),
+            Vector3((-cz * sy * cx) + (sz * sx), (-sz * sy * cx) - (cz * sx), cy * cx),
+        };
+        const std::array<float, 3> scale = {m_scale.x, m_scale.y, m_scale.z};
+        const Vector3& t = m_translation;
+
+        // T * R * S scales the columns of R
+        m_matrix = Matrix4x4(std::array<float, 16>{
+            r[0].x * scale[0], r[0].y * scale[0], r[0].z * scale[0], 0.0f,
+            r[1].x * scale[1], r[1].y * scale[1], r[1].z * scale[1], 0.0f,
+            r[2].x * scale[2], r[2].y * scale[2], r[2].z * scale[2], 0.0f,
+            t.x, t.y, t.z, 1.0f,
+        });
+
+        if (std::abs(scale[0] * scale[1] * scale[2]) < std::numeric_limits<float>::epsilon()) {
+            m_inverse_matrix = Matrix4x4::identity();
+        } else {
+            // S^-1 * R^T * T^-1: row i of the 3x3 part is column i of R divided by scale i
+            std::array<float, 16> inverse{};
+            for (std::size_t i = 0; i < 3; ++i) {
+                const Vector3 row = r.at(i) / scale.at(i);
+                inverse.at(i) = row.x;
+                inverse.at(4 + i) = row.y;
+                inverse.at(8 + i) = row.z;
+                inverse.at(12 + i) = -row.dot(t);
+            }
+            inverse[15] = 1.0f;
+            m_inverse_matrix = Matrix4x4(inverse);
+        }
+        m_normal_matrix = m_inverse_matrix.transposed();
+        m_dirty = false;
     }
 } // namespace di_renderer::math
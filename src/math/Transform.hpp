@@ -20,11 +20,24 @@ namespace di_renderer::math {
         const Vector3& get_scale() const;
         const Vector3& get_rotation() const;
 
-        Matrix4x4 get_matrix() const;
+        // Model matrix T * Rz * Ry * Rx * S. The matrices are cached and rebuilt on the first query after a
+        // setter, so repeated queries are free. Like any lazily filled cache this makes concurrent const calls unsafe.
+        const Matrix4x4& get_matrix() const;
+        // identity when a scale component is zero, like Matrix4x4::inverse()
+        const Matrix4x4& get_inverse_matrix() const;
+        // inverse-transpose of the model matrix, only its upper 3x3 part is meaningful
+        const Matrix4x4& get_normal_matrix() const;
 
       private:
         Vector3 m_translation;
         Vector3 m_rotation;
         Vector3 m_scale;
+
+        mutable Matrix4x4 m_matrix;
+        mutable Matrix4x4 m_inverse_matrix;
+        mutable Matrix4x4 m_normal_matrix;
+        mutable bool m_dirty = true;
+
+        void update_matrices() const;
     };
 } // namespace di_renderer::math
@@ -8,8 +8,8 @@ namespace di_renderer::math {
         float y;
         float z;
 
-        Vector3();
-        Vector3(float x, float y, float z);
+        constexpr Vector3() noexcept : x(0.0f), y(0.0f), z(0.0f) {}
+        constexpr Vector3(const float x, const float y, const float z) noexcept : x(x), y(y), z(z) {}
 
         float length() const;
         Vector3 normalized() const;
@@ -4,10 +4,6 @@
 
 namespace di_renderer::math {
 
-    Vector4::Vector4() : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
-
-    Vector4::Vector4(const float x, const float y, const float z, const float w) : x(x), y(y), z(z), w(w) {}
-
     float Vector4::length() const {
         return std::sqrt((x * x) + (y * y) + (z * z) + (w * w));
     }
@@ -9,8 +9,9 @@ namespace di_renderer::math {
         float z;
         float w;
 
-        Vector4();
-        Vector4(float x, float y, float z, float w);
+        constexpr Vector4() noexcept : x(0.0f), y(0.0f), z(0.0f), w(0.0f) {}
+        constexpr Vector4(const float x, const float y, const float z, const float w) noexcept
+            : x(x), y(y), z(z), w(w) {}
 
         float length() const;
         Vector4 normalized() const;
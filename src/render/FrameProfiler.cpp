@@ -0,0 +1,239 @@
+#include "FrameProfiler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+
+namespace di_renderer::graphics {
+    namespace {
+        constexpr std::array<const char*, FRAME_STAGE_COUNT> STAGE_NAMES = {
+            "bounds", "uniforms", "culling", "vertex_assembly", "upload", "draw"};
+        constexpr std::array<const char*, GPU_PASS_COUNT> GPU_PASS_NAMES = {"mesh", "wireframe"};
+
+        template <typename... Args> std::string format(const char* pattern, Args... args) {
+            std::array<char, 256> line{};
+            const int size = std::snprintf(line.data(), line.size(), pattern, args...);
+            return {line.data(), static_cast<std::size_t>(std::clamp(size, 0, static_cast<int>(line.size()) - 1))};
+        }
+
+        std::string format_gpu_ms(const double ms) {
+            return ms < 0.0 ? std::string("--") : format("%.2f", ms);
+        }
+    } // namespace
+
+    double get_percentile(std::vector<double> values, const double fraction) {
+        if (values.empty()) {
+            return 0.0;
+        }
+        const auto rank = static_cast<std::size_t>(std::ceil(std::clamp(fraction, 0.0, 1.0) * values.size()));
+        const std::size_t index = rank == 0 ? 0 : rank - 1;
+        std::nth_element(values.begin(), values.begin() + static_cast<std::ptrdiff_t>(index), values.end());
+        return values[index];
+    }
+
+    FrameProfiler::ScopedTimer::ScopedTimer(FrameProfiler* profiler, const FrameStage stage)
+        : m_profiler(profiler != nullptr && profiler->is_recording() ? profiler : nullptr), m_stage(stage) {
+        if (m_profiler != nullptr) {
+            m_outer_stage = m_profiler->enter_stage(stage);
+        }
+    }
+
+    FrameProfiler::ScopedTimer::~ScopedTimer() {
+        if (m_profiler != nullptr) {
+            m_profiler->leave_stage(m_stage, m_outer_stage);
+        }
+    }
+
+    void FrameProfiler::set_enabled(const bool enabled) {
+        if (enabled && !m_enabled) {
+            m_history.assign(HISTORY_SIZE, FrameRecord{});
+            m_recorded = 0;
+        }
+        m_enabled = enabled;
+        m_in_frame = false;
+        m_running_stage = -1;
+    }
+
+    void FrameProfiler::begin_frame() {
+        if (!m_enabled) {
+            return;
+        }
+        m_current = FrameRecord{};
+        m_current.frame = m_next_frame;
+        m_running_stage = -1;
+        m_in_frame = true;
+        m_frame_start = Clock::now();
+    }
+
+    void FrameProfiler::end_frame() {
+        if (!is_recording()) {
+            return;
+        }
+        m_current.cpu_ms = std::chrono::duration<double, std::milli>(Clock::now() - m_frame_start).count();
+        m_history[m_next_frame % HISTORY_SIZE] = m_current;
+        m_recorded = std::min(m_recorded + 1, HISTORY_SIZE);
+        ++m_next_frame;
+        m_in_frame = false;
+    }
+
+    FrameProfiler::ScopedTimer FrameProfiler::time(const FrameStage stage) {
+        return {this, stage};
+    }
+
+    int FrameProfiler::enter_stage(const FrameStage stage) {
+        const auto now = Clock::now();
+        const int outer_stage = m_running_stage;
+        if (outer_stage >= 0) {
+            m_current.stage_ms[outer_stage] += std::chrono::duration<double, std::milli>(now - m_stage_start).count();
+        }
+        m_running_stage = static_cast<int>(stage);
+        m_stage_start = now;
+        return outer_stage;
+    }
+
+    void FrameProfiler::leave_stage(const FrameStage stage, const int outer_stage) {
+        const auto now = Clock::now();
+        m_current.stage_ms[static_cast<std::size_t>(stage)] +=
+            std::chrono::duration<double, std::milli>(now - m_stage_start).count();
+        m_running_stage = outer_stage;
+        m_stage_start = now;
+    }
+
+    void FrameProfiler::count_draw(const std::size_t triangles, const std::size_t lines) {
+        if (is_recording()) {
+            ++m_current.draw_calls;
+            m_current.triangles += triangles;
+            m_current.lines += lines;
+        }
+    }
+
+    void FrameProfiler::count_upload(const std::size_t bytes) {
+        if (is_recording()) {
+            m_current.uploaded_bytes += bytes;
+        }
+    }
+
+    void FrameProfiler::count_meshes(const std::size_t drawn, const std::size_t culled) {
+        if (is_recording()) {
+            m_current.meshes_drawn += drawn;
+            m_current.meshes_culled += culled;
+        }
+    }
+
+    void FrameProfiler::set_gpu_time(const std::uint64_t frame, const GpuPass pass, const double ms) {
+        if (!m_enabled || frame >= m_next_frame || m_next_frame - frame > m_recorded) {
+            return;
+        }
+        m_history[frame % HISTORY_SIZE].gpu_ms[static_cast<std::size_t>(pass)] = ms;
+    }
+
+    std::vector<FrameRecord> FrameProfiler::get_history() const {
+        std::vector<FrameRecord> history;
+        history.reserve(m_recorded);
+        for (std::uint64_t frame = m_next_frame - m_recorded; frame < m_next_frame; ++frame) {
+            history.push_back(m_history[frame % HISTORY_SIZE]);
+        }
+        return history;
+    }
+
+    FrameSummary FrameProfiler::summarize() const {
+        const std::vector<FrameRecord> history = get_history();
+        FrameSummary summary;
+        summary.frames = history.size();
+        if (history.empty()) {
+            return summary;
+        }
+
+        std::vector<double> cpu_ms;
+        std::array<std::vector<double>, GPU_PASS_COUNT> gpu_ms;
+        for (const auto& record : history) {
+            cpu_ms.push_back(record.cpu_ms);
+            for (std::size_t stage = 0; stage < FRAME_STAGE_COUNT; ++stage) {
+                summary.stage_mean_ms[stage] += record.stage_ms[stage] / static_cast<double>(history.size());
+            }
+            for (std::size_t pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+                if (record.gpu_ms[pass] >= 0.0) {
+                    gpu_ms[pass].push_back(record.gpu_ms[pass]);
+                }
+            }
+            summary.uploaded_bytes += record.uploaded_bytes;
+        }
+        summary.cpu_p50_ms = get_percentile(cpu_ms, 0.50);
+        summary.cpu_p95_ms = get_percentile(cpu_ms, 0.95);
+        summary.cpu_p99_ms = get_percentile(cpu_ms, 0.99);
+        summary.cpu_max_ms = *std::max_element(cpu_ms.begin(), cpu_ms.end());
+        for (std::size_t pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+            if (!gpu_ms[pass].empty()) {
+                summary.gpu_p50_ms[pass] = get_percentile(gpu_ms[pass], 0.50);
+            }
+        }
+        summary.last = history.back();
+        return summary;
+    }
+
+    std::string FrameProfiler::format_summary() const {
+        const FrameSummary summary = summarize();
+        if (summary.frames == 0) {
+            return "No frames recorded";
+        }
+        const FrameRecord& last = summary.last;
+        std::string text;
+        text += format("%zu frames  CPU p50 %.2f  p95 %.2f  p99 %.2f  max %.2f ms\n", summary.frames,
+                       summary.cpu_p50_ms, summary.cpu_p95_ms, summary.cpu_p99_ms, summary.cpu_max_ms);
+        text += "GPU p50  mesh " + format_gpu_ms(summary.gpu_p50_ms[0]) + "  wireframe " +
+                format_gpu_ms(summary.gpu_p50_ms[1]) + " ms\n";
+        text += format("CPU mean  bounds %.2f  uniforms %.2f  culling %.2f\n", summary.stage_mean_ms[0],
+                       summary.stage_mean_ms[1], summary.stage_mean_ms[2]);
+        text += format("          assembly %.2f  upload %.2f  draw %.2f ms\n", summary.stage_mean_ms[3],
+                       summary.stage_mean_ms[4], summary.stage_mean_ms[5]);
+        text += format("%zu draw calls  %zu triangles  %zu lines  %zu meshes drawn  %zu culled\n", last.draw_calls,
+                       last.triangles, last.lines, last.meshes_drawn, last.meshes_culled);
+        text += format("Uploaded %zu B last frame, %zu B in %zu frames", last.uploaded_bytes, summary.uploaded_bytes,
+                       summary.frames);
+        return text;
+    }
+
+    void FrameProfiler::write_report(const std::string& filename) const {
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            throw std::runtime_error("Could not open file " + filename);
+        }
+
+        const std::string summary = format_summary();
+        for (std::size_t begin = 0; begin <= summary.size();) {
+            const std::size_t end = std::min(summary.find('\n', begin), summary.size());
+            file << "# " << summary.substr(begin, end - begin) << '\n';
+            begin = end + 1;
+        }
+
+        file << "frame,cpu_ms";
+        for (const char* name : STAGE_NAMES) {
+            file << ',' << name << "_ms";
+        }
+        for (const char* name : GPU_PASS_NAMES) {
+            file << ",gpu_" << name << "_ms";
+        }
+        file << ",draw_calls,triangles,lines,uploaded_bytes,meshes_drawn,meshes_culled\n";
+
+        for (const auto& record : get_history()) {
+            file << record.frame << ',' << record.cpu_ms;
+            for (const double ms : record.stage_ms) {
+                file << ',' << ms;
+            }
+            // passes without a result stay empty
+            for (const double ms : record.gpu_ms) {
+                file << ',';
+                if (ms >= 0.0) {
+                    file << ms;
+                }
+            }
+            file << ',' << record.draw_calls << ',' << record.triangles << ',' << record.lines << ','
+                 << record.uploaded_bytes << ',' << record.meshes_drawn << ',' << record.meshes_culled << '\n';
+        }
+        if (!file.flush()) {
+            throw std::runtime_error("Could not write file " + filename);
+        }
+    }
+} // namespace di_renderer::graphics
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace di_renderer::graphics {
+    // CPU stages of a viewport frame
+    enum class FrameStage : std::uint8_t {
+        BOUNDS = 0,          // scene bounds, aspect ratio and projection planes
+        UNIFORMS = 1,        // per-frame uniform setup
+        CULLING = 2,         // view-frustum culling
+        VERTEX_ASSEMBLY = 3, // welding new meshes into vertex streams
+        UPLOAD = 4,          // buffer uploads of new meshes
+        DRAW = 5,            // draw submission
+    };
+    constexpr std::size_t FRAME_STAGE_COUNT = 6;
+
+    // Passes timed on the GPU with GL_TIME_ELAPSED queries, see GpuTimer
+    enum class GpuPass : std::uint8_t {
+        MESH = 0,
+        WIREFRAME = 1,
+    };
+    constexpr std::size_t GPU_PASS_COUNT = 2;
+
+    struct FrameRecord {
+        std::uint64_t frame = 0;
+        // begin_frame to end_frame
+        double cpu_ms = 0.0;
+        // exclusive: a stage timed inside another one is not counted in the outer stage
+        std::array<double, FRAME_STAGE_COUNT> stage_ms{};
+        // negative until the query result arrives, and for passes that did not run
+        std::array<double, GPU_PASS_COUNT> gpu_ms{-1.0, -1.0};
+        std::size_t draw_calls = 0;
+        std::size_t triangles = 0;
+        std::size_t lines = 0;
+        std::size_t uploaded_bytes = 0;
+        std::size_t meshes_drawn = 0;
+        std::size_t meshes_culled = 0;
+    };
+
+    struct FrameSummary {
+        std::size_t frames = 0;
+        double cpu_p50_ms = 0.0;
+        double cpu_p95_ms = 0.0;
+        double cpu_p99_ms = 0.0;
+        double cpu_max_ms = 0.0;
+        std::array<double, FRAME_STAGE_COUNT> stage_mean_ms{};
+        // over the frames that have a result, negative when none has
+        std::array<double, GPU_PASS_COUNT> gpu_p50_ms{-1.0, -1.0};
+        // over all recorded frames
+        std::size_t uploaded_bytes = 0;
+        FrameRecord last;
+    };
+
+    // Nearest-rank percentile, fraction in [0, 1]. 0 for an empty array.
+    double get_percentile(std::vector<double> values, double fraction);
+
+    // Per-frame CPU stage times, GPU pass times and draw/upload counters of the last HISTORY_SIZE frames.
+    // Belongs to the render thread, nothing here is synchronized.
+    class FrameProfiler {
+      public:
+        static constexpr std::size_t HISTORY_SIZE = 240;
+
+        // Adds the time until its destruction to a stage of the current frame. A timer started inside another
+        // one pauses the outer stage, so stage times never overlap.
+        class ScopedTimer {
+          public:
+            ScopedTimer(FrameProfiler* profiler, FrameStage stage);
+            ~ScopedTimer();
+            ScopedTimer(const ScopedTimer&) = delete;
+            ScopedTimer& operator=(const ScopedTimer&) = delete;
+            ScopedTimer(ScopedTimer&&) = delete;
+            ScopedTimer& operator=(ScopedTimer&&) = delete;
+
+          private:
+            // nullptr while the profiler is idle
+            FrameProfiler* m_profiler;
+            FrameStage m_stage;
+            int m_outer_stage = -1;
+        };
+
+        // Disabled by default. While disabled every call below is a no-op. Enabling starts a fresh history.
+        void set_enabled(bool enabled);
+        bool is_enabled() const noexcept {
+            return m_enabled;
+        }
+
+        void begin_frame();
+        void end_frame();
+        // index of the frame being recorded, GPU results are matched to frames by it
+        std::uint64_t get_frame_index() const noexcept {
+            return m_next_frame;
+        }
+
+        [[nodiscard]] ScopedTimer time(FrameStage stage);
+        void count_draw(std::size_t triangles, std::size_t lines);
+        void count_upload(std::size_t bytes);
+        void count_meshes(std::size_t drawn, std::size_t culled);
+        // Results arrive a few frames late, they are dropped once their frame has left the history
+        void set_gpu_time(std::uint64_t frame, GpuPass pass, double ms);
+
+        // oldest frame first
+        std::vector<FrameRecord> get_history() const;
+        FrameSummary summarize() const;
+        // a few lines of plain text for the viewport overlay
+        std::string format_summary() const;
+        // The summary as '#' comment lines, then a CSV row per recorded frame. Throws std::runtime_error when the
+        // file can't be written.
+        void write_report(const std::string& filename) const;
+
+      private:
+        using Clock = std::chrono::steady_clock;
+
+        bool m_enabled = false;
+        bool m_in_frame = false;
+        std::uint64_t m_next_frame = 0;
+        FrameRecord m_current;
+        Clock::time_point m_frame_start;
+        // stage whose time is accumulating, -1 for none
+        int m_running_stage = -1;
+        Clock::time_point m_stage_start;
+        // ring buffer, frame f is stored at f % HISTORY_SIZE
+        std::vector<FrameRecord> m_history;
+        std::size_t m_recorded = 0;
+
+        bool is_recording() const noexcept {
+            return m_enabled && m_in_frame;
+        }
+        // returns the stage that was running
+        int enter_stage(FrameStage stage);
+        void leave_stage(FrameStage stage, int outer_stage);
+    };
+} // namespace di_renderer::graphics
@@ -0,0 +1,103 @@
+#include "GLState.hpp"
+
+#include <algorithm>
+#include <cstddef>
+
+namespace di_renderer::graphics {
+
+    namespace {
+        // Stores value and reports whether it differs from what was cached
+        template <typename T> bool update(std::optional<T>& cached, const T& value) {
+            if (cached.has_value() && *cached == value) {
+                return false;
+            }
+            cached = value;
+            return true;
+        }
+    } // namespace
+
+    void GLState::invalidate() noexcept {
+        *this = GLState{};
+    }
+
+    void GLState::use_program(const GLuint program) {
+        if (update(m_program, program)) {
+            glUseProgram(program);
+        }
+    }
+
+    void GLState::bind_vertex_array(const GLuint vao) {
+        if (update(m_vertex_array, vao)) {
+            glBindVertexArray(vao);
+        }
+    }
+
+    void GLState::active_texture(const GLenum unit) {
+        if (update(m_active_texture, unit)) {
+            glActiveTexture(unit);
+            m_texture_2d.reset(); // bindings are per unit
+        }
+    }
+
+    void GLState::bind_texture_2d(const GLuint texture) {
+        if (update(m_texture_2d, texture)) {
+            glBindTexture(GL_TEXTURE_2D, texture);
+        }
+    }
+
+    void GLState::set_enabled(const GLenum capability, const bool enabled) {
+        const auto it = std::find(TRACKED_CAPABILITIES.begin(), TRACKED_CAPABILITIES.end(), capability);
+        if (it != TRACKED_CAPABILITIES.end() &&
+            !update(m_capabilities.at(static_cast<std::size_t>(it - TRACKED_CAPABILITIES.begin())), enabled)) {
+            return;
+        }
+        if (enabled) {
+            glEnable(capability);
+        } else {
+            glDisable(capability);
+        }
+    }
+
+    void GLState::depth_func(const GLenum func) {
+        if (update(m_depth_func, func)) {
+            glDepthFunc(func);
+        }
+    }
+
+    void GLState::depth_mask(const GLboolean mask) {
+        if (update(m_depth_mask, mask)) {
+            glDepthMask(mask);
+        }
+    }
+
+    void GLState::cull_face(const GLenum mode) {
+        if (update(m_cull_face, mode)) {
+            glCullFace(mode);
+        }
+    }
+
+    void GLState::front_face(const GLenum mode) {
+        if (update(m_front_face, mode)) {
+            glFrontFace(mode);
+        }
+    }
+
+    void GLState::polygon_mode(const GLenum mode) {
+        if (update(m_polygon_mode, mode)) {
+            glPolygonMode(GL_FRONT_AND_BACK, mode);
+        }
+    }
+
+    void GLState::polygon_offset(const GLfloat factor, const GLfloat units) {
+        if (update(m_polygon_offset, std::array<GLfloat, 2>{factor, units})) {
+            glPolygonOffset(factor, units);
+        }
+    }
+
+    void GLState::line_width(const GLfloat width) {
+        if (update(m_line_width, width)) {
+            glLineWidth(width);
+        }
+    }
+
+} // namespace di_renderer::graphics
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <array>
+#include <epoxy/gl.h>
+#include <optional>
+
+namespace di_renderer::graphics {
+
+    // Shadow copy of the bits of GL state the renderer touches, so setting a value that is already current
+    // costs no driver call. Only valid while all changes to that state go through it; call invalidate()
+    // after anything else (a new context, a third-party helper) may have changed it.
+    class GLState {
+      public:
+        void invalidate() noexcept;
+
+        void use_program(GLuint program);
+        void bind_vertex_array(GLuint vao);
+        void active_texture(GLenum unit);
+        void bind_texture_2d(GLuint texture);
+
+        void set_enabled(GLenum capability, bool enabled);
+        void depth_func(GLenum func);
+        void depth_mask(GLboolean mask);
+        void cull_face(GLenum mode);
+        void front_face(GLenum mode);
+        void polygon_mode(GLenum mode);
+        void polygon_offset(GLfloat factor, GLfloat units);
+        void line_width(GLfloat width);
+
+      private:
+        static constexpr std::array<GLenum, 4> TRACKED_CAPABILITIES = {GL_DEPTH_TEST, GL_CULL_FACE,
+                                                                       GL_POLYGON_OFFSET_FILL, GL_MULTISAMPLE};
+
+        std::optional<GLuint> m_program;
+        std::optional<GLuint> m_vertex_array;
+        std::optional<GLenum> m_active_texture;
+        std::optional<GLuint> m_texture_2d;
+        std::array<std::optional<bool>, TRACKED_CAPABILITIES.size()> m_capabilities;
+        std::optional<GLenum> m_depth_func;
+        std::optional<GLboolean> m_depth_mask;
+        std::optional<GLenum> m_cull_face;
+        std::optional<GLenum> m_front_face;
+        std::optional<GLenum> m_polygon_mode;
+        std::optional<std::array<GLfloat, 2>> m_polygon_offset;
+        std::optional<GLfloat> m_line_width;
+    };
+
+} // namespace di_renderer::graphics
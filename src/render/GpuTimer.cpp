@@ -0,0 +1,82 @@
+#include "GpuTimer.hpp"
+
+namespace di_renderer::graphics {
+    bool GpuTimer::create() {
+        if (m_valid) {
+            return true;
+        }
+        // core since 3.3, but software drivers may still report zero counter bits
+        GLint bits = 0;
+        glGetQueryiv(GL_TIME_ELAPSED, GL_QUERY_COUNTER_BITS, &bits);
+        if (bits <= 0) {
+            return false;
+        }
+        for (auto& frame_queries : m_queries) {
+            for (auto& query : frame_queries) {
+                glGenQueries(1, &query.id);
+                query.pending = false;
+            }
+        }
+        m_valid = true;
+        return true;
+    }
+
+    void GpuTimer::destroy() {
+        if (!m_valid) {
+            return;
+        }
+        if (m_active) {
+            glEndQuery(GL_TIME_ELAPSED);
+            m_active = false;
+        }
+        for (auto& frame_queries : m_queries) {
+            for (auto& query : frame_queries) {
+                glDeleteQueries(1, &query.id);
+                query = Query{};
+            }
+        }
+        m_valid = false;
+    }
+
+    void GpuTimer::begin(const std::uint64_t frame, const GpuPass pass) {
+        if (!m_valid || m_active) {
+            return;
+        }
+        // restarting a query discards a result that never arrived
+        Query& query = m_queries[frame % LATENCY][static_cast<std::size_t>(pass)];
+        query.frame = frame;
+        query.pending = true;
+        glBeginQuery(GL_TIME_ELAPSED, query.id);
+        m_active = true;
+    }
+
+    void GpuTimer::end() {
+        if (m_active) {
+            glEndQuery(GL_TIME_ELAPSED);
+            m_active = false;
+        }
+    }
+
+    void GpuTimer::collect(FrameProfiler& profiler) {
+        if (!m_valid) {
+            return;
+        }
+        for (auto& frame_queries : m_queries) {
+            for (std::size_t pass = 0; pass < GPU_PASS_COUNT; ++pass) {
+                Query& query = frame_queries[pass];
+                if (!query.pending) {
+                    continue;
+                }
+                GLint available = 0;
+                glGetQueryObjectiv(query.id, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available == 0) {
+                    continue;
+                }
+                GLuint64 elapsed_ns = 0;
+                glGetQueryObjectui64v(query.id, GL_QUERY_RESULT, &elapsed_ns);
+                query.pending = false;
+                profiler.set_gpu_time(query.frame, static_cast<GpuPass>(pass), static_cast<double>(elapsed_ns) / 1.0e6);
+            }
+        }
+    }
+} // namespace di_renderer::graphics
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "FrameProfiler.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <epoxy/gl.h>
+
+namespace di_renderer::graphics {
+    // GL_TIME_ELAPSED queries around the passes of a frame. Each frame uses its own set of queries and results are
+    // collected once the GPU has them, so timing never makes the CPU wait for the GPU.
+    // GL names are released only through destroy(), which must run while the owning context is current.
+    class GpuTimer {
+      public:
+        // frames whose queries can be in flight, a result still missing after that is dropped
+        static constexpr std::size_t LATENCY = 4;
+
+        // Creates nothing and returns false when the driver reports no timer bits
+        bool create();
+        void destroy();
+        bool valid() const noexcept {
+            return m_valid;
+        }
+
+        // One pass at a time, GL has a single GL_TIME_ELAPSED query slot
+        void begin(std::uint64_t frame, GpuPass pass);
+        void end();
+        // Hands the results that are ready to the profiler, without blocking
+        void collect(FrameProfiler& profiler);
+
+      private:
+        struct Query {
+            GLuint id = 0;
+            std::uint64_t frame = 0;
+            bool pending = false;
+        };
+
+        std::array<std::array<Query, GPU_PASS_COUNT>, LATENCY> m_queries{};
+        bool m_valid = false;
+        bool m_active = false;
+    };
+} // namespace di_renderer::graphics
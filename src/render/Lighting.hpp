@@ -0,0 +1,23 @@
+#pragma once
+
+#include "math/Camera.hpp"
+#include "math/Vector3.hpp"
+
+#include <algorithm>
+
+namespace di_renderer::graphics {
+
+    // Position of the light that follows the camera: ahead of it and a little above, further out the further
+    // the camera is from its target
+    inline math::Vector3 get_camera_light_position(const math::Camera& camera) {
+        const math::Vector3 camera_pos = camera.get_position();
+        const math::Vector3 camera_forward = (camera.get_target() - camera_pos).normalized();
+        const math::Vector3 camera_right = camera_forward.cross(math::Vector3(0.0f, 1.0f, 0.0f)).normalized();
+        const math::Vector3 camera_up = camera_right.cross(camera_forward).normalized();
+
+        const float light_distance = std::max(2.0f, (camera_pos - camera.get_target()).length() * 0.5f);
+        const math::Vector3 light_offset = camera_forward * light_distance + camera_up * (light_distance * 0.3f);
+        return camera_pos + light_offset;
+    }
+
+} // namespace di_renderer::graphics
@@ -3,6 +3,7 @@
 #include "Triangle.hpp"
 #include "core/AppData.hpp"
 #include "core/RenderMode.hpp"
+#include "math/BoundingBox.hpp"
 #include "math/Camera.hpp"
 #include "math/Matrix4x4.hpp"
 #include "math/Transform.hpp"
@@ -13,6 +14,7 @@
 #include <array>
 #include <cmath>
 #include <cstddef>
+#include <cstdint>
 #include <cstring>
 #include <epoxy/gl.h>
 #include <gdkmm/pixbuf.h>
@@ -24,11 +26,7 @@
 
 using di_renderer::render::OpenGLArea;
 
-OpenGLArea::OpenGLArea()
-    : m_scene_min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
-                  std::numeric_limits<float>::max()),
-      m_scene_max(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
-                  -std::numeric_limits<float>::max()) {
+OpenGLArea::OpenGLArea() {
     set_has_depth_buffer(true);
     set_auto_render(true);
     set_required_version(3, 3);
@@ -41,6 +39,7 @@ OpenGLArea::OpenGLArea()
     add_events(Gdk::KEY_PRESS_MASK | Gdk::KEY_RELEASE_MASK);
 
     m_render_dispatcher.connect(sigc::mem_fun(*this, &OpenGLArea::on_dispatch_render));
+    m_app_data.set_change_callback([this] { request_render(); });
 }
 
 OpenGLArea::~OpenGLArea() {
@@ -61,24 +60,19 @@ void OpenGLArea::on_realize() {
     GLint depth_bits = 0;
     glGetIntegerv(GL_DEPTH_BITS, &depth_bits);
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
+    m_gl_state.invalidate();
     glClearDepth(1.0f);
-
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
-
-    glEnable(GL_MULTISAMPLE);
+    m_gl_state.set_enabled(GL_MULTISAMPLE, true);
 
     m_shader_program = di_renderer::graphics::create_shader_program();
+    m_camera_uniforms_version = 0;
 
-    if (m_shader_program == 0) {
+    if (!m_shader_program.valid()) {
         std::cerr << "Failed to create shader program" << '\n';
         return;
     }
 
-    di_renderer::graphics::init_mesh_batch();
+    m_gpu_timer.create();
     m_gl_initialized.store(true);
 }
 
@@ -144,22 +138,33 @@ bool OpenGLArea::on_motion_notify_event(GdkEventMotion* event) {
         m_app_data.get_current_camera().orbit_around_target(static_cast<float>(dx), static_cast<float>(dy));
     }
 
-    queue_draw();
+    request_render();
     return true;
 }
 
 bool OpenGLArea::on_key_press_event(GdkEventKey* event) {
     m_pressed_keys.insert(event->keyval);
     parse_keyboard_movement();
-    queue_draw();
+    request_render();
+    start_animation();
     return true;
 }
 
 bool OpenGLArea::on_key_release_event(GdkEventKey* event) {
     m_pressed_keys.erase(event->keyval);
     parse_keyboard_movement();
+    if (m_pressed_keys.empty()) {
+        stop_animation();
+    }
     return true;
 }
+
+bool OpenGLArea::on_focus_out_event(GdkEventFocus* event) {
+    // releases are not delivered without focus, don't keep animating for keys that may be long gone
+    m_pressed_keys.clear();
+    stop_animation();
+    return Gtk::GLArea::on_focus_out_event(event);
+}
 bool OpenGLArea::on_scroll_event(GdkEventScroll* scroll_event) {
     float val = 0;
     switch (scroll_event->direction) {
@@ -173,6 +178,7 @@ bool OpenGLArea::on_scroll_event(GdkEventScroll* scroll_event) {
         break;
     }
     m_app_data.get_current_camera().zoom(val);
+    request_render();
     return true;
 }
 
@@ -209,126 +215,21 @@ bool OpenGLArea::key_pressed(unsigned int key) {
     return m_pressed_keys.find(key) != m_pressed_keys.end();
 }
 
-void OpenGLArea::calculate_camera_planes(const di_renderer::math::Vector3& min_pos, // NOLINT
-                                         const di_renderer::math::Vector3& max_pos, float distance,
-                                         di_renderer::math::Camera& camera) {
-    const di_renderer::math::Vector3 size(max_pos.x - min_pos.x, max_pos.y - min_pos.y, max_pos.z - min_pos.z);
-    const float max_dimension = std::max({size.x, size.y, size.z});
-
-    float near_plane = 0.1f;
-    float far_plane = 100.0f;
-
-    if (max_dimension < 1.0f) {
-        near_plane = std::max(0.01f, distance * 0.01f);
-        far_plane = (distance * 5.0f) + (max_dimension * 10.0f);
-    } else if (max_dimension < 10.0f) {
-        near_plane = std::max(0.1f, distance * 0.05f);
-        far_plane = (distance * 10.0f) + (max_dimension * 10.0f);
-    } else if (max_dimension < 100.0f) {
-        near_plane = std::max(0.5f, distance * 0.1f);
-        far_plane = (distance * 20.0f) + (max_dimension * 10.0f);
-    } else {
-        near_plane = std::max(1.0f, distance * 0.2f);
-        far_plane = (distance * 50.0f) + (max_dimension * 10.0f);
-    }
-
-    const float min_far_plane = 1000.0f;
-    far_plane = std::max(far_plane, min_far_plane);
-
-    const float max_ratio = 10000.0f;
-    if (far_plane / near_plane > max_ratio) {
-        near_plane = far_plane / max_ratio;
-    }
-
-    camera.set_planes(near_plane, far_plane);
-}
-
-di_renderer::math::Vector3 OpenGLArea::transform_vertex(const di_renderer::math::Vector3& vertex, // NOLINT
-                                                        const di_renderer::math::Transform& transform) {
-    const di_renderer::math::Matrix4x4 transform_matrix = transform.get_matrix();
-    const di_renderer::math::Vector4 transformed =
-        transform_matrix * di_renderer::math::Vector4(vertex.x, vertex.y, vertex.z, 1.0f);
-    return {transformed.x, transformed.y, transformed.z};
-}
-
-void OpenGLArea::update_scene_bounds() {
-    m_scene_min = di_renderer::math::Vector3(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
-                                             std::numeric_limits<float>::max());
-    m_scene_max = di_renderer::math::Vector3(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
-                                             -std::numeric_limits<float>::max());
-    bool has_vertices = false;
-
-    const auto& meshes = m_app_data.get_meshes();
-    for (const auto& mesh : meshes) {
-        if (mesh.vertices.empty()) {
-            continue;
-        }
-        has_vertices = true;
-
-        auto& transform = const_cast<di_renderer::core::Mesh&>(mesh).get_transform(); // NOLINT
-        auto [min, max] = get_transformed_bounds(mesh, transform);
-
-        m_scene_min = di_renderer::math::Vector3(std::min(m_scene_min.x, min.x), std::min(m_scene_min.y, min.y),
-                                                 std::min(m_scene_min.z, min.z));
-        m_scene_max = di_renderer::math::Vector3(std::max(m_scene_max.x, max.x), std::max(m_scene_max.y, max.y),
-                                                 std::max(m_scene_max.z, max.z));
-    }
-    m_bounds_valid = has_vertices;
-}
-
-std::pair<di_renderer::math::Vector3, di_renderer::math::Vector3>
-OpenGLArea::get_transformed_bounds(const di_renderer::core::Mesh& mesh, const di_renderer::math::Transform& transform) {
-    di_renderer::math::Vector3 min(std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
-                                   std::numeric_limits<float>::max());
-    di_renderer::math::Vector3 max(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
-                                   -std::numeric_limits<float>::max());
-
-    for (const auto& vertex : mesh.vertices) {
-        const di_renderer::math::Vector3 transformed = transform_vertex(vertex, transform);
-        min = di_renderer::math::Vector3(std::min(min.x, transformed.x), std::min(min.y, transformed.y),
-                                         std::min(min.z, transformed.z));
-        max = di_renderer::math::Vector3(std::max(max.x, transformed.x), std::max(max.y, transformed.y),
-                                         std::max(max.z, transformed.z));
-    }
-    return {min, max};
-}
-
 void OpenGLArea::update_camera_for_mesh() {
     auto& app_data = get_app_data();
     if (!m_gl_initialized.load() || app_data.is_meshes_empty()) {
         return;
     }
 
-    update_scene_bounds();
-
-    if (!m_bounds_valid) {
+    const di_renderer::math::BoundingBox bounds = app_data.get_scene_bounds();
+    if (bounds.is_empty()) {
         auto& camera = app_data.get_current_camera();
         camera = di_renderer::math::Camera(); // Uses fixed default constructor
         return;
     }
 
     auto& camera = app_data.get_current_camera();
-    const di_renderer::math::Vector3 center((m_scene_min.x + m_scene_max.x) * 0.5f,
-                                            (m_scene_min.y + m_scene_max.y) * 0.5f,
-                                            (m_scene_min.z + m_scene_max.z) * 0.5f);
-
-    const di_renderer::math::Vector3 size(m_scene_max.x - m_scene_min.x, m_scene_max.y - m_scene_min.y,
-                                          m_scene_max.z - m_scene_min.z);
-    const float max_dimension = std::max({size.x, size.y, size.z});
-    const float model_radius = max_dimension * 0.5f;
-
-    const float fov_rad = 45.0f * static_cast<float>(M_PI) / 180.0f;
-    const float base_distance = model_radius / std::tan(fov_rad / 2.0f);
-
-    float distance = base_distance * 1.5f;
-
-    distance = std::max(1.0f, distance);
-    distance = std::min(500.0f, distance);
-
-    camera.set_position(di_renderer::math::Vector3(center.x, center.y, center.z + distance));
-    camera.set_target(center);
-
-    calculate_camera_planes(m_scene_min, m_scene_max, distance, camera);
+    camera.fit_to_bounds(bounds);
 
     const int width = get_width();
     const int height = get_height();
@@ -344,7 +245,8 @@ void OpenGLArea::update_dynamic_projection() {
     }
 
     auto& app_data = get_app_data();
-    if (app_data.is_meshes_empty() || !m_bounds_valid) {
+    const di_renderer::math::BoundingBox bounds = app_data.get_scene_bounds();
+    if (bounds.is_empty()) {
         return;
     }
 
@@ -353,14 +255,13 @@ void OpenGLArea::update_dynamic_projection() {
     const di_renderer::math::Vector3 target = camera.get_target();
     const float distance = (camera_pos - target).length();
 
-    calculate_camera_planes(m_scene_min, m_scene_max, distance, camera);
+    camera.fit_planes_to_bounds(bounds, distance);
 }
 
 void OpenGLArea::reset_camera_for_new_model() {
-    m_bounds_valid = false;
     m_app_data.get_current_camera() = di_renderer::math::Camera();
     update_camera_for_mesh();
-    queue_draw();
+    request_render();
 }
 
 void OpenGLArea::on_map() {
@@ -369,9 +270,9 @@ void OpenGLArea::on_map() {
     grab_focus();
 
     if (m_gl_initialized.load()) {
-        start_animation();
         update_camera_for_mesh();
     }
+    request_render();
 }
 
 void OpenGLArea::on_unmap() {
@@ -384,14 +285,22 @@ di_renderer::core::AppData& OpenGLArea::get_app_data() noexcept {
     return m_app_data;
 }
 
+void OpenGLArea::request_render() {
+    if (!m_render_requested.exchange(true)) {
+        m_render_dispatcher.emit();
+    }
+}
+
 void OpenGLArea::on_dispatch_render() {
+    m_render_requested.store(false);
     if (m_should_render.load() && get_realized() && get_mapped()) {
         queue_render();
     }
 }
 
+// Continuous rendering, only runs while keys are held
 void OpenGLArea::start_animation() {
-    if (m_render_connection.connected()) {
+    if (m_render_connection.connected() || !m_should_render.load()) {
         return;
     }
 
@@ -399,12 +308,12 @@ void OpenGLArea::start_animation() {
 }
 
 bool OpenGLArea::on_animation_timeout() {
-    if (!m_should_render.load() || !m_gl_initialized.load()) {
+    if (!m_should_render.load() || !m_gl_initialized.load() || m_pressed_keys.empty()) {
         return false;
     }
 
-    m_render_dispatcher.emit();
-    return m_should_render.load();
+    request_render();
+    return true;
 }
 
 void OpenGLArea::stop_animation() {
@@ -431,24 +340,29 @@ void OpenGLArea::cleanup_resources() {
     }
     m_texture_cache.clear();
 
-    if (m_shader_program != 0u) {
-        glUseProgram(m_shader_program);
-        const GLint use_texture_loc = glGetUniformLocation(m_shader_program, "uUseTexture");
-        if (use_texture_loc != -1) {
-            glUniform1i(use_texture_loc, 0);
+    if (m_shader_program.valid()) {
+        m_gl_state.use_program(m_shader_program.id());
+        if (m_shader_program.uniforms().use_texture != -1) {
+            glUniform1i(m_shader_program.uniforms().use_texture, 0);
+        }
+        m_gl_state.use_program(0);
+        m_gl_state.bind_vertex_array(0);
+
+        for (auto& [_, entry] : m_mesh_buffers) {
+            entry.buffer.destroy();
         }
-        glUseProgram(0);
+        m_mesh_buffers.clear();
 
-        di_renderer::graphics::destroy_mesh_batch();
+        m_gpu_timer.destroy();
         di_renderer::graphics::destroy_shader_program(m_shader_program);
-        m_shader_program = 0;
     }
 
     m_texture_loader.cleanup();
+    m_gl_state.invalidate();
 }
 
 bool OpenGLArea::on_render(const Glib::RefPtr<Gdk::GLContext>& /*context*/) {
-    if (!m_gl_initialized.load() || !m_should_render.load() || m_shader_program == 0) {
+    if (!m_gl_initialized.load() || !m_should_render.load() || !m_shader_program.valid()) {
         return false;
     }
 
@@ -459,190 +373,203 @@ bool OpenGLArea::on_render(const Glib::RefPtr<Gdk::GLContext>& /*context*/) {
         return false;
     }
 
-    const int width = get_width();
-    const int height = get_height();
-    if (width > 0 && height > 0) {
-        const float aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
-        auto& camera = m_app_data.get_current_camera();
-        camera.set_aspect_ratio(aspect_ratio);
+    using di_renderer::graphics::FrameStage;
+    using di_renderer::graphics::GpuPass;
+    m_profiler.begin_frame();
+    const bool time_gpu = m_profiler.is_enabled() && m_gpu_timer.valid();
+    if (time_gpu) {
+        m_gpu_timer.collect(m_profiler);
     }
 
-    update_dynamic_projection();
+    {
+        const auto timer = m_profiler.time(FrameStage::BOUNDS);
+        const int width = get_width();
+        const int height = get_height();
+        if (width > 0 && height > 0) {
+            const float aspect_ratio = static_cast<float>(width) / static_cast<float>(height);
+            auto& camera = m_app_data.get_current_camera();
+            camera.set_aspect_ratio(aspect_ratio);
+        }
+
+        update_dynamic_projection();
+    }
 
+    // depth writes must be on for the clear to reach the depth buffer
+    m_gl_state.depth_mask(GL_TRUE);
     glClearColor(0.1f, 0.2f, 0.3f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glClearDepth(1.0f);
 
-    glEnable(GL_DEPTH_TEST);
-    glDepthFunc(GL_LESS);
-    glDepthMask(GL_TRUE);
+    m_gl_state.set_enabled(GL_DEPTH_TEST, true);
+    m_gl_state.depth_func(GL_LESS);
 
-    glEnable(GL_CULL_FACE);
-    glCullFace(GL_BACK);
-    glFrontFace(GL_CCW);
+    m_gl_state.set_enabled(GL_CULL_FACE, true);
+    m_gl_state.cull_face(GL_BACK);
+    m_gl_state.front_face(GL_CCW);
 
-    set_default_uniforms();
-    draw_current_mesh();
+    // polygon offset does not apply to line primitives, so the surfaces are pushed back instead of the edges
+    // pulled forward
+    const bool wireframe_mode = get_app_data().is_render_mode_enabled(core::RenderMode::POLYGON);
+    m_gl_state.set_enabled(GL_POLYGON_OFFSET_FILL, wireframe_mode);
+    m_gl_state.polygon_offset(1.0f, 1.0f);
 
-    auto& app_data = get_app_data();
-    const bool wireframe_mode = app_data.is_render_mode_enabled(core::RenderMode::POLYGON);
+    {
+        const auto timer = m_profiler.time(FrameStage::UNIFORMS);
+        set_default_uniforms();
+    }
+    {
+        const auto timer = m_profiler.time(FrameStage::CULLING);
+        cull_meshes();
+    }
+    m_profiler.count_meshes(m_culling_stats.drawn, m_culling_stats.culled);
 
+    if (time_gpu) {
+        m_gpu_timer.begin(m_profiler.get_frame_index(), GpuPass::MESH);
+    }
+    draw_current_mesh();
+    if (time_gpu) {
+        m_gpu_timer.end();
+    }
     if (wireframe_mode) {
+        if (time_gpu) {
+            m_gpu_timer.begin(m_profiler.get_frame_index(), GpuPass::WIREFRAME);
+        }
         draw_wireframe_overlay();
+        if (time_gpu) {
+            m_gpu_timer.end();
+        }
     }
+    release_unused_mesh_buffers();
 
+    m_profiler.end_frame();
     return true;
 }
 
 void OpenGLArea::draw_wireframe_overlay() {
-    if ((m_shader_program == 0u) || !m_gl_initialized.load() || m_app_data.is_meshes_empty()) {
+    if (!m_shader_program.valid() || !m_gl_initialized.load() || m_app_data.is_meshes_empty()) {
         return;
     }
 
-    const auto& meshes = m_app_data.get_meshes();
-    for (const auto& mesh : meshes) {
-        if (mesh.vertices.empty()) {
-            continue;
-        }
-
-        std::vector<di_renderer::graphics::Vertex> vertices;
-        vertices.reserve(mesh.vertices.size());
-
-        std::vector<unsigned int> indices;
-        for (const auto& face : mesh.faces) {
-            if (face.size() >= 3) {
-                indices.push_back(face[0].vi);
-                indices.push_back(face[1].vi);
-                indices.push_back(face[2].vi);
-
-                for (size_t i = 3; i < face.size(); ++i) {
-                    indices.push_back(face[0].vi);
-                    indices.push_back(face[i - 1].vi);
-                    indices.push_back(face[i].vi);
-                }
-            }
-        }
+    m_gl_state.use_program(m_shader_program.id());
+    const auto& uniforms = m_shader_program.uniforms();
+    if (uniforms.use_texture != -1) {
+        glUniform1i(uniforms.use_texture, 0);
+    }
+    if (uniforms.tint != -1) {
+        glUniform3f(uniforms.tint, 1.0f, 0.5f, 0.0f);
+    }
+    m_gl_state.active_texture(GL_TEXTURE0);
+    m_gl_state.bind_texture_2d(0);
+    m_gl_state.line_width(1.5f);
 
-        if (indices.empty()) {
-            continue;
+    const auto timer = m_profiler.time(di_renderer::graphics::FrameStage::DRAW);
+    for (const auto* mesh : m_visible_meshes) {
+        const auto& mesh_buffer = acquire_mesh_buffer(*mesh);
+        di_renderer::graphics::set_model_uniforms(m_shader_program.uniforms(), mesh->get_transform());
+        mesh_buffer.draw_edges(m_gl_state);
+        if (mesh_buffer.get_edge_count() != 0) {
+            m_profiler.count_draw(0, mesh_buffer.get_edge_count());
         }
+    }
+}
 
-        auto& transform = const_cast<di_renderer::core::Mesh&>(mesh).get_transform(); // NOLINT
-        for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-            di_renderer::graphics::Vertex vertex{};
-
-            const di_renderer::math::Vector3 transformed = transform_vertex(mesh.vertices[i], transform);
-            vertex.position[0] = transformed.x;
-            vertex.position[1] = transformed.y;
-            vertex.position[2] = transformed.z;
-
-            if (i < mesh.normals.size()) {
-                vertex.normal[0] = mesh.normals[i].x;
-                vertex.normal[1] = mesh.normals[i].y;
-                vertex.normal[2] = mesh.normals[i].z;
-            } else {
-                vertex.normal[0] = 0.0f;
-                vertex.normal[1] = 1.0f;
-                vertex.normal[2] = 0.0f;
-            }
-
-            if (i < mesh.texture_vertices.size()) {
-                vertex.uv[0] = mesh.texture_vertices[i].u;
-                vertex.uv[1] = m_flip_uv_y ? (1.0f - mesh.texture_vertices[i].v) : mesh.texture_vertices[i].v;
-            } else {
-                vertex.uv[0] = 0.0f;
-                vertex.uv[1] = 0.0f;
-            }
-
-            vertex.color[0] = 1.0f;
-            vertex.color[1] = 0.5f;
-            vertex.color[2] = 0.0f;
+void OpenGLArea::cull_meshes() {
+    const auto& camera = m_app_data.get_current_camera();
+    if (camera.get_version() != m_frustum_camera_version) {
+        m_frustum_camera_version = camera.get_version();
+        m_frustum = di_renderer::math::Frustum(camera.get_view_projection_matrix());
+    }
 
-            vertices.push_back(vertex);
+    m_visible_meshes.clear();
+    m_culling_stats = {};
+    for (const auto& mesh : m_app_data.get_meshes()) {
+        if (mesh.vertices.empty()) {
+            continue;
         }
 
-        if (vertices.empty()) {
-            continue;
+        // the bounding sphere rejects most hidden meshes with one dot product per plane, the box the rest
+        const di_renderer::math::BoundingBox bounds = mesh.get_world_bounds();
+        const float radius = (bounds.get_size() * 0.5f).length();
+        if (m_frustum.intersects_sphere(bounds.get_center(), radius) && m_frustum.intersects(bounds)) {
+            m_visible_meshes.push_back(&mesh);
+            ++m_culling_stats.drawn;
+        } else {
+            keep_mesh_buffer(mesh);
+            ++m_culling_stats.culled;
         }
+    }
+}
 
-        glUseProgram(m_shader_program);
+const OpenGLArea::CullingStats& OpenGLArea::get_culling_stats() const noexcept {
+    return m_culling_stats;
+}
 
-        const GLint use_texture_loc = glGetUniformLocation(m_shader_program, "uUseTexture");
-        if (use_texture_loc != -1) {
-            glUniform1i(use_texture_loc, 0);
-        }
+void OpenGLArea::set_profiling_enabled(const bool enabled) {
+    m_profiler.set_enabled(enabled);
+    request_render();
+}
 
-        glBindTexture(GL_TEXTURE_2D, 0);
-        glActiveTexture(GL_TEXTURE0);
+const di_renderer::graphics::FrameProfiler& OpenGLArea::get_frame_profiler() const noexcept {
+    return m_profiler;
+}
 
-        glEnable(GL_POLYGON_OFFSET_LINE);
-        glPolygonOffset(-1.0f, -1.0f);
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
-        glLineWidth(1.5f);
+const di_renderer::graphics::MeshBuffer& OpenGLArea::acquire_mesh_buffer(const di_renderer::core::Mesh& mesh) {
+    auto [it, inserted] = m_mesh_buffers.try_emplace(mesh.get_geometry_revision());
+    auto& entry = it->second;
+    entry.in_use = true;
 
-        di_renderer::graphics::draw_indexed_mesh(vertices.data(), vertices.size(), indices.data(), indices.size(),
-                                                 m_shader_program);
+    // buffers hold model-space data, transform edits are handled by set_model_uniforms()
+    if (inserted) {
+        using di_renderer::graphics::FrameStage;
+        const auto assembled = [&] {
+            const auto timer = m_profiler.time(FrameStage::VERTEX_ASSEMBLY);
+            return di_renderer::graphics::assemble_mesh(mesh, m_flip_uv_y);
+        }();
+        const auto timer = m_profiler.time(FrameStage::UPLOAD);
+        di_renderer::graphics::upload_assembled_mesh(m_gl_state, entry.buffer, assembled);
+        m_profiler.count_upload(assembled.get_upload_size());
+    }
+    return entry.buffer;
+}
 
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-        glDisable(GL_POLYGON_OFFSET_LINE);
+void OpenGLArea::keep_mesh_buffer(const di_renderer::core::Mesh& mesh) {
+    if (const auto it = m_mesh_buffers.find(mesh.get_geometry_revision()); it != m_mesh_buffers.end()) {
+        it->second.in_use = true;
     }
+}
 
-    glUseProgram(0);
+void OpenGLArea::release_unused_mesh_buffers() {
+    for (auto it = m_mesh_buffers.begin(); it != m_mesh_buffers.end();) {
+        if (!it->second.in_use) {
+            // a deleted VAO name can be handed out again, the tracker must not believe it is still bound
+            m_gl_state.bind_vertex_array(0);
+            it->second.buffer.destroy();
+            it = m_mesh_buffers.erase(it);
+        } else {
+            it->second.in_use = false;
+            ++it;
+        }
+    }
 }
 
 void OpenGLArea::set_default_uniforms() { // NOLINT
-    if ((m_shader_program == 0u) || !m_gl_initialized.load()) {
+    if (!m_shader_program.valid() || !m_gl_initialized.load()) {
         return;
     }
 
-    glUseProgram(m_shader_program);
+    m_gl_state.use_program(m_shader_program.id());
 
-    std::array<GLfloat, 16> model_matrix = {1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f,
-                                            0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 0.0f, 1.0f};
+    const auto& uniforms = m_shader_program.uniforms();
+    const GLint light_color1_loc = uniforms.light_color1;
+    const GLint light_pos2_loc = uniforms.light_pos2;
+    const GLint light_color2_loc = uniforms.light_color2;
+    const GLint use_light2_loc = uniforms.use_light2;
+    const GLint texture_loc = uniforms.texture;
 
+    // uniform values live in the program object, the camera-dependent ones only change with the camera
     const auto& camera = m_app_data.get_current_camera();
-    const di_renderer::math::Matrix4x4 view_matrix = camera.get_view_matrix();
-    const di_renderer::math::Matrix4x4 proj_matrix = camera.get_projection_matrix();
-
-    const GLint model_loc = glGetUniformLocation(m_shader_program, "uModel");
-    const GLint view_loc = glGetUniformLocation(m_shader_program, "uView");
-    const GLint proj_loc = glGetUniformLocation(m_shader_program, "uProjection");
-    const GLint camera_pos_loc = glGetUniformLocation(m_shader_program, "uCameraPos");
-    const GLint light_pos1_loc = glGetUniformLocation(m_shader_program, "uLightPos1");
-    const GLint light_color1_loc = glGetUniformLocation(m_shader_program, "uLightColor1");
-    const GLint light_pos2_loc = glGetUniformLocation(m_shader_program, "uLightPos2");
-    const GLint light_color2_loc = glGetUniformLocation(m_shader_program, "uLightColor2");
-    const GLint use_light2_loc = glGetUniformLocation(m_shader_program, "uUseLight2");
-    const GLint texture_loc = glGetUniformLocation(m_shader_program, "uTexture");
-    const GLint normal_matrix_loc = glGetUniformLocation(m_shader_program, "uNormalMatrix");
-
-    if (model_loc != -1) {
-        glUniformMatrix4fv(model_loc, 1, GL_FALSE, model_matrix.data());
-    }
-    if (view_loc != -1) {
-        glUniformMatrix4fv(view_loc, 1, GL_FALSE, view_matrix.data());
-    }
-    if (proj_loc != -1) {
-        glUniformMatrix4fv(proj_loc, 1, GL_FALSE, proj_matrix.data());
-    }
-
-    const di_renderer::math::Vector3 camera_pos = camera.get_position();
-    if (camera_pos_loc != -1) {
-        glUniform3f(camera_pos_loc, camera_pos.x, camera_pos.y, camera_pos.z);
-    }
-
-    const di_renderer::math::Vector3 camera_forward = (camera.get_target() - camera_pos).normalized();
-    const di_renderer::math::Vector3 camera_right =
-        camera_forward.cross(di_renderer::math::Vector3(0.0f, 1.0f, 0.0f)).normalized();
-    const di_renderer::math::Vector3 camera_up = camera_right.cross(camera_forward).normalized();
-
-    const float light_distance = std::max(2.0f, (camera_pos - camera.get_target()).length() * 0.5f);
-    const di_renderer::math::Vector3 light_offset =
-        camera_forward * light_distance + camera_up * (light_distance * 0.3f);
-    const di_renderer::math::Vector3 light1_pos = camera_pos + light_offset;
-
-    if (light_pos1_loc != -1) {
-        glUniform3f(light_pos1_loc, light1_pos.x, light1_pos.y, light1_pos.z);
+    if (camera.get_version() != m_camera_uniforms_version) {
+        m_camera_uniforms_version = camera.get_version();
+        di_renderer::graphics::set_camera_uniforms(m_shader_program.uniforms(), camera);
     }
 
     if (light_color1_loc != -1) {
@@ -652,7 +579,8 @@ void OpenGLArea::set_default_uniforms() { // NOLINT
     auto& app_data = get_app_data();
     const bool lighting_mode = app_data.is_render_mode_enabled(core::RenderMode::LIGHTING);
 
-    if (!m_bounds_valid) {
+    const di_renderer::math::BoundingBox scene_bounds = app_data.get_scene_bounds();
+    if (scene_bounds.is_empty()) {
         const di_renderer::math::Vector3 default_light2_pos(0.0f, 10.0f, 0.0f);
 
         if (light_pos2_loc != -1) {
@@ -667,14 +595,12 @@ void OpenGLArea::set_default_uniforms() { // NOLINT
         }
     } else {
         if (use_light2_loc != -1) {
-            glUniform1i(use_light2_loc, lighting_mode && m_bounds_valid ? 1 : 0);
+            glUniform1i(use_light2_loc, lighting_mode ? 1 : 0);
         }
 
-        if (lighting_mode && m_bounds_valid) {
-            const di_renderer::math::Vector3 center((m_scene_min.x + m_scene_max.x) * 0.5f,
-                                                    (m_scene_min.y + m_scene_max.y) * 0.5f,
-                                                    (m_scene_min.z + m_scene_max.z) * 0.5f);
-            const float scene_height = m_scene_max.y - m_scene_min.y;
+        if (lighting_mode) {
+            const di_renderer::math::Vector3 center = scene_bounds.get_center();
+            const float scene_height = scene_bounds.get_size().y;
             const float light2_height = std::max(scene_height * 10.5f, 2.0f);
             const di_renderer::math::Vector3 light2_pos =
                 center + di_renderer::math::Vector3(0.0f, light2_height, 0.0f);
@@ -691,89 +617,23 @@ void OpenGLArea::set_default_uniforms() { // NOLINT
     if (texture_loc != -1) {
         glUniform1i(texture_loc, 0);
     }
-
-    std::array<GLfloat, 9> identity_normal_matrix = {1.0f, 0.0f, 0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 0.0f, 1.0f};
-
-    if (normal_matrix_loc != -1) {
-        glUniformMatrix3fv(normal_matrix_loc, 1, GL_FALSE, identity_normal_matrix.data());
+    if (uniforms.tint != -1) {
+        glUniform3f(uniforms.tint, 1.0f, 1.0f, 1.0f);
     }
 }
 void OpenGLArea::draw_current_mesh() { // NOLINT
-    if ((m_shader_program == 0u) || !m_gl_initialized.load()) {
+    if (!m_shader_program.valid() || !m_gl_initialized.load()) {
         return;
     }
 
     auto& app_data = get_app_data();
-
-    if (app_data.is_meshes_empty()) {
-        return;
-    }
+    const auto timer = m_profiler.time(di_renderer::graphics::FrameStage::DRAW);
 
     try {
-        const auto& meshes = app_data.get_meshes();
-
-        for (const auto& mesh : meshes) {
-            if (mesh.vertices.empty()) {
-                continue;
-            }
-
-            std::vector<di_renderer::graphics::Vertex> vertices;
-            vertices.reserve(mesh.vertices.size());
-
-            std::vector<unsigned int> indices;
-            for (const auto& face : mesh.faces) {
-                if (face.size() >= 3) {
-                    indices.push_back(face[0].vi);
-                    indices.push_back(face[1].vi);
-                    indices.push_back(face[2].vi);
-
-                    for (size_t i = 3; i < face.size(); ++i) {
-                        indices.push_back(face[0].vi);
-                        indices.push_back(face[i - 1].vi);
-                        indices.push_back(face[i].vi);
-                    }
-                }
-            }
-
-            if (indices.empty()) {
-                continue;
-            }
-
-            auto& transform = const_cast<di_renderer::core::Mesh&>(mesh).get_transform(); // NOLINT
-            for (size_t i = 0; i < mesh.vertices.size(); ++i) {
-                di_renderer::graphics::Vertex vertex{};
-
-                const di_renderer::math::Vector3 transformed = transform_vertex(mesh.vertices[i], transform);
-                vertex.position[0] = transformed.x;
-                vertex.position[1] = transformed.y;
-                vertex.position[2] = transformed.z;
-
-                if (i < mesh.normals.size()) {
-                    vertex.normal[0] = mesh.normals[i].x;
-                    vertex.normal[1] = mesh.normals[i].y;
-                    vertex.normal[2] = mesh.normals[i].z;
-                } else {
-                    vertex.normal[0] = 0.0f;
-                    vertex.normal[1] = 1.0f;
-                    vertex.normal[2] = 0.0f;
-                }
-
-                if (i < mesh.texture_vertices.size()) {
-                    vertex.uv[0] = mesh.texture_vertices[i].u;
-                    vertex.uv[1] = m_flip_uv_y ? (1.0f - mesh.texture_vertices[i].v) : mesh.texture_vertices[i].v;
-                } else {
-                    vertex.uv[0] = 0.0f;
-                    vertex.uv[1] = 0.0f;
-                }
-
-                vertex.color[0] = 1.0f;
-                vertex.color[1] = 1.0f;
-                vertex.color[2] = 1.0f;
-
-                vertices.push_back(vertex);
-            }
-
-            if (vertices.empty()) {
+        for (const auto* mesh_ptr : m_visible_meshes) {
+            const auto& mesh = *mesh_ptr;
+            const auto& mesh_buffer = acquire_mesh_buffer(mesh);
+            if (mesh_buffer.empty()) {
                 continue;
             }
 
@@ -789,7 +649,9 @@ void OpenGLArea::draw_current_mesh() { // NOLINT
                     texture_id = cache_it->second;
                     has_texture = (texture_id != 0);
                 } else {
+                    const auto upload_timer = m_profiler.time(di_renderer::graphics::FrameStage::UPLOAD);
                     texture_id = m_texture_loader.load_texture(tex_filename, m_current_mesh_path);
+                    m_gl_state.invalidate(); // the loader binds textures behind our back
                     has_texture = (texture_id != 0);
                     m_texture_cache[tex_filename] = texture_id;
                 }
@@ -797,25 +659,19 @@ void OpenGLArea::draw_current_mesh() { // NOLINT
 
             const bool use_textures_in_shader = render_textures && has_texture_filename && has_texture;
 
-            glUseProgram(m_shader_program);
+            m_gl_state.use_program(m_shader_program.id());
 
-            const GLint use_texture_loc = glGetUniformLocation(m_shader_program, "uUseTexture");
+            const GLint use_texture_loc = m_shader_program.uniforms().use_texture;
             if (use_texture_loc != -1) {
                 glUniform1i(use_texture_loc, use_textures_in_shader ? 1 : 0);
             }
 
-            if (use_textures_in_shader && has_texture) {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, texture_id);
-            } else {
-                glActiveTexture(GL_TEXTURE0);
-                glBindTexture(GL_TEXTURE_2D, 0);
-            }
-
-            di_renderer::graphics::draw_indexed_mesh(vertices.data(), vertices.size(), indices.data(), indices.size(),
-                                                     m_shader_program);
+            m_gl_state.active_texture(GL_TEXTURE0);
+            m_gl_state.bind_texture_2d(use_textures_in_shader && has_texture ? texture_id : 0);
 
-            glBindTexture(GL_TEXTURE_2D, 0);
+            di_renderer::graphics::set_model_uniforms(m_shader_program.uniforms(), mesh.get_transform());
+            mesh_buffer.draw(m_gl_state);
+            m_profiler.count_draw(mesh_buffer.get_triangle_count(), 0);
         }
     } catch (const std::exception& e) {
         std::cerr << "Error drawing meshes: " << e.what() << '\n';
@@ -829,6 +685,6 @@ void OpenGLArea::set_current_mesh_path(const std::string& path) {
 void OpenGLArea::on_camera_changed() {
     if (m_gl_initialized.load() && get_realized() && get_mapped()) {
         update_dynamic_projection();
-        queue_draw();
+        request_render();
     }
 }
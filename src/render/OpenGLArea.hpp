@@ -1,15 +1,23 @@
 #pragma once
 
+#include "FrameProfiler.hpp"
+#include "GLState.hpp"
+#include "GpuTimer.hpp"
 #include "TextureLoader.hpp"
 #include "Triangle.hpp"
 #include "core/AppData.hpp"
 #include "glibmm/dispatcher.h"
 #include "glibmm/main.h"
+#include "math/BoundingBox.hpp"
 #include "math/Camera.hpp"
+#include "math/Frustum.hpp"
 #include "math/Transform.hpp"
 #include "render/TextureLoader.hpp"
 
+#include <array>
 #include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include <epoxy/gl_generated.h>
 #include <gtkmm/glarea.h>
 #include <gtkmm/main.h>
@@ -28,9 +36,22 @@ namespace di_renderer::render {
         OpenGLArea& operator=(OpenGLArea&&) = delete;
 
         void reset_camera_for_new_model();
+        // Schedules one frame, any number of requests before it is drawn collapse into it. Safe from any thread.
+        void request_render();
         di_renderer::core::AppData& get_app_data() noexcept;
         void set_current_mesh_path(const std::string& path);
 
+        // Meshes drawn and skipped by view-frustum culling in the last frame
+        struct CullingStats {
+            std::size_t drawn = 0;
+            std::size_t culled = 0;
+        };
+        const CullingStats& get_culling_stats() const noexcept;
+
+        // CPU stage times, GPU pass times and draw/upload counters of recent frames, recorded while enabled
+        void set_profiling_enabled(bool enabled);
+        const di_renderer::graphics::FrameProfiler& get_frame_profiler() const noexcept;
+
       protected:
         // Widget overrides
         void on_realize() override;
@@ -43,6 +64,7 @@ namespace di_renderer::render {
         bool on_key_press_event(GdkEventKey* event) override;
         bool on_key_release_event(GdkEventKey* event) override;
         bool on_scroll_event(GdkEventScroll* scroll_event) override;
+        bool on_focus_out_event(GdkEventFocus* event) override;
         void on_map() override;
         void on_unmap() override;
         void on_camera_changed();
@@ -57,38 +79,48 @@ namespace di_renderer::render {
         void update_camera_for_mesh();
         void update_dynamic_projection();
         void set_default_uniforms();
+        void cull_meshes();
         void draw_current_mesh();
         void draw_wireframe_overlay();
         std::unordered_map<std::string, GLuint> m_texture_cache;
-        di_renderer::math::Vector3 m_scene_min;
-        di_renderer::math::Vector3 m_scene_max;
-        bool m_bounds_valid = false;
-        std::vector<std::vector<unsigned int>> m_wireframe_indices;
-        bool m_wireframe_dirty = true;
         bool m_flip_uv_y = false;
         std::string m_current_mesh_path;
-        void update_scene_bounds();
-        std::pair<di_renderer::math::Vector3, di_renderer::math::Vector3>
-        get_transformed_bounds(const di_renderer::core::Mesh& mesh, const di_renderer::math::Transform& transform);
-        void update_wireframe_data();
-        std::vector<di_renderer::graphics::Vertex> get_transformed_vertices(const di_renderer::core::Mesh& mesh);
+
+        struct MeshBufferEntry {
+            di_renderer::graphics::MeshBuffer buffer;
+            bool in_use = false;
+        };
+        // keyed by core::Mesh geometry revision, so copies of one mesh share their buffers
+        std::unordered_map<std::uint64_t, MeshBufferEntry> m_mesh_buffers;
+        const di_renderer::graphics::MeshBuffer& acquire_mesh_buffer(const di_renderer::core::Mesh& mesh);
+        // marks the buffers of a mesh that is skipped this frame as still needed, without creating any
+        void keep_mesh_buffer(const di_renderer::core::Mesh& mesh);
+        void release_unused_mesh_buffers();
 
         void cleanup_resources();
-        void calculate_camera_planes(const di_renderer::math::Vector3& min_pos,
-                                     const di_renderer::math::Vector3& max_pos, float distance,
-                                     di_renderer::math::Camera& camera);
-        di_renderer::math::Vector3 transform_vertex(const di_renderer::math::Vector3& vertex,
-                                                    const di_renderer::math::Transform& transform);
 
         di_renderer::core::AppData m_app_data;
         di_renderer::graphics::TextureLoader m_texture_loader;
-        GLuint m_shader_program = 0;
+        di_renderer::graphics::ShaderProgram m_shader_program;
+        // Camera::get_version() of the view/projection/light uniforms in m_shader_program, 0 = never uploaded
+        std::uint64_t m_camera_uniforms_version = 0;
+        // meshes inside the view frustum this frame, filled by cull_meshes() before any buffer or draw work
+        std::vector<const di_renderer::core::Mesh*> m_visible_meshes;
+        CullingStats m_culling_stats;
+        di_renderer::graphics::FrameProfiler m_profiler;
+        di_renderer::graphics::GpuTimer m_gpu_timer;
+        di_renderer::math::Frustum m_frustum;
+        // Camera::get_version() m_frustum was extracted for
+        std::uint64_t m_frustum_camera_version = 0;
+        // state of this widget's GL context, reset whenever the context is (re)created
+        di_renderer::graphics::GLState m_gl_state;
         double m_last_x{0.0}, m_last_y{0.0};
         bool m_lmb_drag = false;
         bool m_rmb_drag = false;
         std::unordered_set<unsigned int> m_pressed_keys;
         std::atomic<bool> m_gl_initialized{false};
         std::atomic<bool> m_should_render{false};
+        std::atomic<bool> m_render_requested{false};
         Glib::RefPtr<Glib::MainContext> m_main_context;
         sigc::connection m_render_connection;
         Glib::Dispatcher m_render_dispatcher;
@@ -0,0 +1,437 @@
+#include "SoftwareRasterizer.hpp"
+
+#include "math/Simd.hpp"
+#include "math/Vector4.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace di_renderer::graphics {
+    namespace {
+        // vertices and triangles per job below which splitting costs more than it saves
+        constexpr std::size_t MIN_VERTEX_CHUNK_SIZE = 4096;
+        constexpr std::size_t MIN_TRIANGLE_CHUNK_SIZE = 1024;
+
+        // constants of fragment_src
+        constexpr float AMBIENT = 0.1f;
+        constexpr float LIGHT1_STRENGTH = 0.8f;
+        constexpr float ALPHA_DISCARD = 0.1f;
+
+        // upper 3x3 of m times v
+        math::Vector3 transform_direction(const math::Matrix4x4& m, const std::array<float, 3>& v) {
+            return {(m(0, 0) * v[0]) + (m(0, 1) * v[1]) + (m(0, 2) * v[2]),
+                    (m(1, 0) * v[0]) + (m(1, 1) * v[1]) + (m(1, 2) * v[2]),
+                    (m(2, 0) * v[0]) + (m(2, 1) * v[1]) + (m(2, 2) * v[2])};
+        }
+
+        math::Vector3 multiply(const math::Vector3& a, const math::Vector3& b) {
+            return {a.x * b.x, a.y * b.y, a.z * b.z};
+        }
+
+        // GL_LINEAR filtering with GL_REPEAT wrapping on the base level
+        std::array<float, 4> sample(const SoftwareTexture& texture, const float u, const float v) {
+            const float x = ((u - std::floor(u)) * static_cast<float>(texture.width)) - 0.5f;
+            const float y = ((v - std::floor(v)) * static_cast<float>(texture.height)) - 0.5f;
+            const float x_floor = std::floor(x);
+            const float y_floor = std::floor(y);
+            const float tx = x - x_floor;
+            const float ty = y - y_floor;
+
+            const auto wrap = [](const int i, const int size) { return ((i % size) + size) % size; };
+            const int x0 = wrap(static_cast<int>(x_floor), texture.width);
+            const int y0 = wrap(static_cast<int>(y_floor), texture.height);
+            const int x1 = wrap(x0 + 1, texture.width);
+            const int y1 = wrap(y0 + 1, texture.height);
+
+            std::array<float, 4> result{};
+            for (std::size_t channel = 0; channel < 4; ++channel) {
+                const auto texel = [&](const int column, const int row) {
+                    const std::size_t pixel = (static_cast<std::size_t>(row) * texture.width) + column;
+                    return static_cast<float>(texture.rgba[(pixel * 4) + channel]) / 255.0f;
+                };
+                const float top = texel(x0, y0) + ((texel(x1, y0) - texel(x0, y0)) * tx);
+                const float bottom = texel(x0, y1) + ((texel(x1, y1) - texel(x0, y1)) * tx);
+                result.at(channel) = top + ((bottom - top) * ty);
+            }
+            return result;
+        }
+
+        std::uint8_t to_unorm8(const float value) {
+            return static_cast<std::uint8_t>(std::lround(std::clamp(value, 0.0f, 1.0f) * 255.0f));
+        }
+    } // namespace
+
+    SoftwareRasterizer::SoftwareRasterizer(const int width, const int height, jobs::JobSystem& jobs)
+        : m_width(width), m_height(height), m_tiles_x((width + TILE_SIZE - 1) / TILE_SIZE),
+          m_tiles_y((height + TILE_SIZE - 1) / TILE_SIZE), m_jobs(&jobs) {
+        if (width <= 0 || height <= 0) {
+            throw std::runtime_error("Bad software framebuffer size");
+        }
+        const auto pixel_count = static_cast<std::size_t>(width) * static_cast<std::size_t>(height);
+        m_color.resize(pixel_count * 3);
+        m_depth.assign(pixel_count, 1.0f);
+    }
+
+    void SoftwareRasterizer::clear(const math::Vector3& color) {
+        const std::array<std::uint8_t, 3> rgb = {to_unorm8(color.x), to_unorm8(color.y), to_unorm8(color.z)};
+        for (std::size_t i = 0; i < m_color.size(); i += 3) {
+            std::copy(rgb.begin(), rgb.end(), m_color.begin() + static_cast<std::ptrdiff_t>(i));
+        }
+        std::fill(m_depth.begin(), m_depth.end(), 1.0f);
+    }
+
+    void SoftwareRasterizer::draw(const Vertex* vertices, const std::size_t vertex_count, const std::uint16_t* indices,
+                                  const std::size_t index_count, const SoftwareShading& shading) {
+        draw_indexed(vertices, vertex_count, indices, index_count, shading);
+    }
+
+    void SoftwareRasterizer::draw(const Vertex* vertices, const std::size_t vertex_count, const std::uint32_t* indices,
+                                  const std::size_t index_count, const SoftwareShading& shading) {
+        draw_indexed(vertices, vertex_count, indices, index_count, shading);
+    }
+
+    std::array<std::uint8_t, 3> SoftwareRasterizer::get_pixel(const int x, const int y) const {
+        const std::size_t index = ((static_cast<std::size_t>(y) * m_width) + x) * 3;
+        return {m_color.at(index), m_color.at(index + 1), m_color.at(index + 2)};
+    }
+
+    float SoftwareRasterizer::get_depth(const int x, const int y) const {
+        return m_depth.at((static_cast<std::size_t>(y) * m_width) + x);
+    }
+
+    template <typename Index>
+    void SoftwareRasterizer::draw_indexed(const Vertex* vertices, const std::size_t vertex_count, const Index* indices,
+                                          const std::size_t index_count, const SoftwareShading& shading) {
+        const std::size_t triangle_count = index_count / 3;
+        if (vertex_count == 0 || triangle_count == 0) {
+            return;
+        }
+        if (const SoftwareTexture* texture = shading.texture;
+            texture != nullptr && texture->rgba.size() != static_cast<std::size_t>(texture->width) *
+                                                               static_cast<std::size_t>(texture->height) * 4) {
+            throw std::runtime_error("Texture data does not match the texture size");
+        }
+        transform_vertices(vertices, vertex_count, shading);
+
+        // every job bins into its own lists, so binning needs no locks and keeps the submission order per bin
+        const std::size_t tile_count = static_cast<std::size_t>(m_tiles_x) * static_cast<std::size_t>(m_tiles_y);
+        const std::size_t bin_count = m_jobs->get_chunk_count(triangle_count, MIN_TRIANGLE_CHUNK_SIZE);
+        if (m_bins.size() < bin_count) {
+            m_bins.resize(bin_count);
+        }
+        m_jobs->parallel_for_each(bin_count, [&](const std::size_t bin_index) {
+            Bin& bin = m_bins[bin_index];
+            bin.triangles.clear();
+            bin.tiles.resize(tile_count);
+            for (auto& tile : bin.tiles) {
+                tile.clear();
+            }
+
+            const auto [begin, end] = jobs::JobSystem::get_chunk_bounds(triangle_count, bin_count, bin_index);
+            for (std::size_t triangle = begin; triangle < end; ++triangle) {
+                const Index* corners = indices + (triangle * 3); // NOLINT(*-pointer-arithmetic)
+                if (corners[0] >= vertex_count || corners[1] >= vertex_count || corners[2] >= vertex_count) {
+                    continue;
+                }
+                clip_and_setup(m_clip_vertices[corners[0]], m_clip_vertices[corners[1]],
+                               m_clip_vertices[corners[2]], bin);
+            }
+        });
+
+        // tiles own disjoint pixels, one job each lets stealing even out how unevenly the triangles spread
+        m_jobs->parallel_for_each(tile_count,
+                                  [&](const std::size_t tile) { rasterize_tile(tile, bin_count, shading); });
+    }
+
+    void SoftwareRasterizer::transform_vertices(const Vertex* vertices, const std::size_t vertex_count,
+                                                const SoftwareShading& shading) {
+        m_clip_vertices.resize(vertex_count);
+        const math::Matrix4x4 model_view_projection = shading.view_projection * shading.model;
+        m_jobs->parallel_for(vertex_count, MIN_VERTEX_CHUNK_SIZE, [&](const std::size_t begin, const std::size_t end) {
+            for (std::size_t i = begin; i < end; ++i) {
+                const Vertex& vertex = vertices[i]; // NOLINT(*-pointer-arithmetic)
+                const math::Vector4 position(vertex.position[0], vertex.position[1], vertex.position[2], 1.0f);
+                const math::Vector4 world = shading.model * position;
+                const math::Vector4 clip = model_view_projection * position;
+
+                ClipVertex& out = m_clip_vertices[i];
+                out.clip = {clip.x, clip.y, clip.z, clip.w};
+                out.world = {world.x, world.y, world.z};
+                out.normal = transform_direction(shading.normal_matrix, vertex.normal).normalized();
+                out.color = multiply({vertex.color[0], vertex.color[1], vertex.color[2]}, shading.tint);
+                out.uv = vertex.uv;
+            }
+        });
+    }
+
+    SoftwareRasterizer::ClipVertex SoftwareRasterizer::interpolate(const ClipVertex& from, const ClipVertex& to,
+                                                                    const float t) {
+        ClipVertex result{};
+        for (std::size_t i = 0; i < 4; ++i) {
+            result.clip.at(i) = from.clip.at(i) + ((to.clip.at(i) - from.clip.at(i)) * t);
+        }
+        result.world = from.world + ((to.world - from.world) * t);
+        result.normal = from.normal + ((to.normal - from.normal) * t);
+        result.color = from.color + ((to.color - from.color) * t);
+        result.uv = {from.uv[0] + ((to.uv[0] - from.uv[0]) * t), from.uv[1] + ((to.uv[1] - from.uv[1]) * t)};
+        return result;
+    }
+
+    void SoftwareRasterizer::clip_and_setup(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                                            Bin& bin) const {
+        // only the near plane is clipped against. Other planes are handled by the screen bounds and the depth
+        // test, but behind the near plane w turns negative and the projection folds over.
+        const std::array<const ClipVertex*, 3> input = {&v0, &v1, &v2};
+        std::array<float, 3> distance{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            distance.at(i) = input.at(i)->clip[2] + input.at(i)->clip[3];
+        }
+        if (distance[0] >= 0.0f && distance[1] >= 0.0f && distance[2] >= 0.0f) {
+            setup_triangle(v0, v1, v2, bin);
+            return;
+        }
+        if (distance[0] < 0.0f && distance[1] < 0.0f && distance[2] < 0.0f) {
+            return;
+        }
+
+        // one triangle clipped by a plane leaves a triangle or a quad
+        std::array<ClipVertex, 4> polygon{};
+        std::size_t size = 0;
+        for (std::size_t i = 0; i < 3; ++i) {
+            const std::size_t next = (i + 1) % 3;
+            if (distance.at(i) >= 0.0f) {
+                polygon.at(size++) = *input.at(i);
+            }
+            if ((distance.at(i) >= 0.0f) != (distance.at(next) >= 0.0f)) {
+                const float t = distance.at(i) / (distance.at(i) - distance.at(next));
+                polygon.at(size++) = interpolate(*input.at(i), *input.at(next), t);
+            }
+        }
+        for (std::size_t i = 1; i + 1 < size; ++i) {
+            setup_triangle(polygon[0], polygon.at(i), polygon.at(i + 1), bin);
+        }
+    }
+
+    void SoftwareRasterizer::setup_triangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2,
+                                            Bin& bin) const {
+        std::array<const ClipVertex*, 3> vertices = {&v0, &v1, &v2};
+        std::array<float, 3> x{};
+        std::array<float, 3> y{};
+        std::array<float, 3> depth{};
+        std::array<float, 3> inv_w{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            const auto& clip = vertices.at(i)->clip;
+            if (!(clip[3] > 0.0f)) {
+                return;
+            }
+            inv_w.at(i) = 1.0f / clip[3];
+            x.at(i) = ((clip[0] * inv_w.at(i) * 0.5f) + 0.5f) * static_cast<float>(m_width);
+            y.at(i) = (0.5f - (clip[1] * inv_w.at(i) * 0.5f)) * static_cast<float>(m_height);
+            depth.at(i) = (clip[2] * inv_w.at(i) * 0.5f) + 0.5f;
+        }
+        if (depth[0] > 1.0f && depth[1] > 1.0f && depth[2] > 1.0f) {
+            return;
+        }
+
+        // y points down on screen, which turns counter-clockwise front faces negative. Back faces, degenerate
+        // triangles and NaNs are dropped, front faces get vertices 1 and 2 swapped so the area is positive.
+        const float area = ((x[1] - x[0]) * (y[2] - y[0])) - ((x[2] - x[0]) * (y[1] - y[0]));
+        if (!(area < 0.0f)) {
+            return;
+        }
+        std::swap(vertices[1], vertices[2]);
+        std::swap(x[1], x[2]);
+        std::swap(y[1], y[2]);
+        std::swap(depth[1], depth[2]);
+        std::swap(inv_w[1], inv_w[2]);
+
+        // pixels whose centers can be inside, clamped in float first so huge coordinates don't overflow int
+        const auto clamp_x = [&](const float value) { return std::clamp(value, -1.0f, static_cast<float>(m_width)); };
+        const auto clamp_y = [&](const float value) {
+            return std::clamp(value, -1.0f, static_cast<float>(m_height));
+        };
+        const int min_x = std::max(0, static_cast<int>(std::ceil(clamp_x(std::min({x[0], x[1], x[2]}) - 0.5f))));
+        const int max_x =
+            std::min(m_width - 1, static_cast<int>(std::floor(clamp_x(std::max({x[0], x[1], x[2]}) - 0.5f))));
+        const int min_y = std::max(0, static_cast<int>(std::ceil(clamp_y(std::min({y[0], y[1], y[2]}) - 0.5f))));
+        const int max_y =
+            std::min(m_height - 1, static_cast<int>(std::floor(clamp_y(std::max({y[0], y[1], y[2]}) - 0.5f))));
+        if (min_x > max_x || min_y > max_y) {
+            return;
+        }
+
+        const auto index = static_cast<std::uint32_t>(bin.triangles.size());
+        SetupTriangle& triangle = bin.triangles.emplace_back();
+        for (std::size_t i = 0; i < 3; ++i) {
+            const std::size_t j = (i + 1) % 3;
+            const std::size_t k = (i + 2) % 3;
+            const float dx = x.at(k) - x.at(j);
+            const float dy = y.at(k) - y.at(j);
+            triangle.a.at(i) = -dy;
+            triangle.b.at(i) = dx;
+            triangle.c.at(i) = (dy * x.at(j)) - (dx * y.at(j));
+            // pixel centers exactly on a shared edge belong to the triangle left of or below it
+            triangle.top_left.at(i) = dy < 0.0f || (dy == 0.0f && dx > 0.0f);
+            triangle.vertices.at(i) = *vertices.at(i);
+        }
+        triangle.inv_area = -1.0f / area;
+        triangle.depth = depth;
+        triangle.inv_w = inv_w;
+        triangle.min_x = min_x;
+        triangle.min_y = min_y;
+        triangle.max_x = max_x;
+        triangle.max_y = max_y;
+
+        for (int tile_y = min_y / TILE_SIZE; tile_y <= max_y / TILE_SIZE; ++tile_y) {
+            for (int tile_x = min_x / TILE_SIZE; tile_x <= max_x / TILE_SIZE; ++tile_x) {
+                bin.tiles[(static_cast<std::size_t>(tile_y) * m_tiles_x) + tile_x].push_back(index);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::rasterize_tile(const std::size_t tile, const std::size_t bin_count,
+                                            const SoftwareShading& shading) {
+        const int tile_x = static_cast<int>(tile % static_cast<std::size_t>(m_tiles_x)) * TILE_SIZE;
+        const int tile_y = static_cast<int>(tile / static_cast<std::size_t>(m_tiles_x)) * TILE_SIZE;
+        const int tile_max_x = std::min(m_width, tile_x + TILE_SIZE) - 1;
+        const int tile_max_y = std::min(m_height, tile_y + TILE_SIZE) - 1;
+
+        for (std::size_t bin_index = 0; bin_index < bin_count; ++bin_index) {
+            const Bin& bin = m_bins[bin_index];
+            for (const std::uint32_t index : bin.tiles[tile]) {
+                const SetupTriangle& triangle = bin.triangles[index];
+                rasterize(triangle, std::max(triangle.min_x, tile_x), std::max(triangle.min_y, tile_y),
+                          std::min(triangle.max_x, tile_max_x), std::min(triangle.max_y, tile_max_y), shading);
+            }
+        }
+    }
+
+    void SoftwareRasterizer::rasterize(const SetupTriangle& triangle, const int min_x, const int min_y,
+                                       const int max_x, const int max_y, const SoftwareShading& shading) {
+        for (int y = min_y; y <= max_y; ++y) {
+            const float py = static_cast<float>(y) + 0.5f;
+            std::array<float, 3> row{};
+            for (std::size_t i = 0; i < 3; ++i) {
+                row.at(i) = (triangle.b.at(i) * py) + triangle.c.at(i);
+            }
+            const std::size_t row_start = static_cast<std::size_t>(y) * m_width;
+
+            int x = min_x;
+#ifdef DI_RENDERER_SSE
+            // four pixels of the row at once: edge functions, inside test, depth and depth test
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 lane_offsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+            for (; x + 3 <= max_x; x += 4) {
+                const __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), lane_offsets);
+                const auto edge = [&](const std::size_t i) {
+                    return _mm_add_ps(_mm_mul_ps(_mm_set1_ps(triangle.a.at(i)), px), _mm_set1_ps(row.at(i)));
+                };
+                const auto is_inside = [&](const std::size_t i, const __m128 value) {
+                    return triangle.top_left.at(i) ? _mm_cmpge_ps(value, zero) : _mm_cmpgt_ps(value, zero);
+                };
+                const __m128 edge0 = edge(0);
+                const __m128 edge1 = edge(1);
+                const __m128 edge2 = edge(2);
+                const __m128 inside = _mm_and_ps(_mm_and_ps(is_inside(0, edge0), is_inside(1, edge1)),
+                                                 is_inside(2, edge2));
+                if (_mm_movemask_ps(inside) == 0) {
+                    continue;
+                }
+                const __m128 depth = _mm_mul_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(edge0, _mm_set1_ps(triangle.depth[0])),
+                                          _mm_mul_ps(edge1, _mm_set1_ps(triangle.depth[1]))),
+                               _mm_mul_ps(edge2, _mm_set1_ps(triangle.depth[2]))),
+                    _mm_set1_ps(triangle.inv_area));
+                const __m128 stored = _mm_loadu_ps(&m_depth[row_start + x]);
+                const int visible = _mm_movemask_ps(
+                    _mm_and_ps(inside, _mm_and_ps(_mm_cmplt_ps(depth, stored), _mm_cmpge_ps(depth, zero))));
+                if (visible == 0) {
+                    continue;
+                }
+
+                std::array<std::array<float, 4>, 3> lanes{};
+                std::array<float, 4> depths{};
+                _mm_storeu_ps(lanes[0].data(), edge0);
+                _mm_storeu_ps(lanes[1].data(), edge1);
+                _mm_storeu_ps(lanes[2].data(), edge2);
+                _mm_storeu_ps(depths.data(), depth);
+                for (std::size_t lane = 0; lane < 4; ++lane) {
+                    if ((visible & (1 << lane)) != 0) {
+                        shade_pixel(triangle, x + static_cast<int>(lane), y,
+                                    {lanes[0].at(lane), lanes[1].at(lane), lanes[2].at(lane)}, depths.at(lane),
+                                    shading);
+                    }
+                }
+            }
+#endif
+            for (; x <= max_x; ++x) {
+                const float px = static_cast<float>(x) + 0.5f;
+                std::array<float, 3> edges{};
+                bool inside = true;
+                float depth = 0.0f;
+                for (std::size_t i = 0; i < 3; ++i) {
+                    edges.at(i) = (triangle.a.at(i) * px) + row.at(i);
+                    inside = inside && (triangle.top_left.at(i) ? edges.at(i) >= 0.0f : edges.at(i) > 0.0f);
+                    depth += edges.at(i) * triangle.depth.at(i);
+                }
+                depth *= triangle.inv_area;
+                if (inside && depth < m_depth[row_start + x] && depth >= 0.0f) {
+                    shade_pixel(triangle, x, y, edges, depth, shading);
+                }
+            }
+        }
+    }
+
+    void SoftwareRasterizer::shade_pixel(const SetupTriangle& triangle, const int x, const int y,
+                                         const std::array<float, 3>& edges, const float depth,
+                                         const SoftwareShading& shading) {
+        // screen-space barycentrics weighted by 1/w give perspective-correct varyings
+        std::array<float, 3> weights{};
+        float weight_sum = 0.0f;
+        for (std::size_t i = 0; i < 3; ++i) {
+            weights.at(i) = edges.at(i) * triangle.inv_w.at(i);
+            weight_sum += weights.at(i);
+        }
+        math::Vector3 world;
+        math::Vector3 normal;
+        math::Vector3 color;
+        std::array<float, 2> uv{};
+        for (std::size_t i = 0; i < 3; ++i) {
+            const float weight = weights.at(i) / weight_sum;
+            const ClipVertex& vertex = triangle.vertices.at(i);
+            world += vertex.world * weight;
+            normal += vertex.normal * weight;
+            color += vertex.color * weight;
+            uv[0] += vertex.uv[0] * weight;
+            uv[1] += vertex.uv[1] * weight;
+        }
+        normal = normal.normalized();
+
+        math::Vector3 light(AMBIENT, AMBIENT, AMBIENT);
+        const float diffuse1 = std::max(normal.dot((shading.light_pos1 - world).normalized()), 0.0f);
+        light += shading.light_color1 * (diffuse1 * LIGHT1_STRENGTH);
+        if (shading.use_light2) {
+            const float diffuse2 = std::max(normal.dot((shading.light_pos2 - world).normalized()), 0.0f);
+            light += shading.light_color2 * diffuse2;
+        }
+        math::Vector3 result = multiply(light, color);
+
+        if (shading.texture != nullptr && shading.texture->width > 0 && shading.texture->height > 0) {
+            const std::array<float, 4> texel = sample(*shading.texture, uv[0], uv[1]);
+            // a discarded fragment leaves depth untouched too
+            if (texel[3] < ALPHA_DISCARD) {
+                return;
+            }
+            result = multiply(result, {texel[0], texel[1], texel[2]});
+        }
+
+        const std::size_t pixel = (static_cast<std::size_t>(y) * m_width) + x;
+        m_depth[pixel] = depth;
+        m_color[pixel * 3] = to_unorm8(result.x);
+        m_color[(pixel * 3) + 1] = to_unorm8(result.y);
+        m_color[(pixel * 3) + 2] = to_unorm8(result.z);
+    }
+
+} // namespace di_renderer::graphics
@@ -0,0 +1,137 @@
+#pragma once
+
+#include "Vertex.hpp"
+#include "jobs/JobSystem.hpp"
+#include "math/Matrix4x4.hpp"
+#include "math/Vector3.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace di_renderer::graphics {
+
+    // RGBA8 texture for the software backend. Row 0 is sampled at v = 0, like the rows TextureLoader uploads.
+    struct SoftwareTexture {
+        int width = 0;
+        int height = 0;
+        std::vector<std::uint8_t> rgba;
+    };
+
+    // Inputs of the built-in shader (vertex_src/fragment_src in Triangle.cpp) for one draw
+    struct SoftwareShading {
+        math::Matrix4x4 model = math::Matrix4x4::identity();
+        // see Transform::get_normal_matrix, only the upper 3x3 is used
+        math::Matrix4x4 normal_matrix = math::Matrix4x4::identity();
+        // projection * view
+        math::Matrix4x4 view_projection = math::Matrix4x4::identity();
+        math::Vector3 tint{1.0f, 1.0f, 1.0f};
+        math::Vector3 light_pos1;
+        math::Vector3 light_color1{1.0f, 1.0f, 1.0f};
+        math::Vector3 light_pos2;
+        math::Vector3 light_color2;
+        bool use_light2 = false;
+        // modulates the color when set, texels with alpha below 0.1 are discarded
+        const SoftwareTexture* texture = nullptr;
+    };
+
+    // CPU implementation of the GL draw path for machines without a usable GL driver. Draws indexed triangle
+    // lists with the built-in shader's lighting, back-face culling (counter-clockwise front faces), near-plane
+    // clipping and a GL_LESS depth test.
+    //
+    // A draw transforms the vertices and sets up the triangles on the job system, bins them into
+    // TILE_SIZE x TILE_SIZE screen tiles and then shades the tiles in parallel. Every tile walks its triangles
+    // in submission order, so the image does not depend on the number of threads.
+    class SoftwareRasterizer {
+      public:
+        static constexpr int TILE_SIZE = 32;
+
+        // Throws std::runtime_error for an empty size
+        SoftwareRasterizer(int width, int height, jobs::JobSystem& jobs = jobs::JobSystem::global());
+
+        int get_width() const noexcept {
+            return m_width;
+        }
+        int get_height() const noexcept {
+            return m_height;
+        }
+
+        // Fills the color buffer and resets depth to the far plane
+        void clear(const math::Vector3& color);
+
+        // Triangles whose indices reach past vertex_count are skipped. Throws std::runtime_error when the
+        // texture's data does not match its size.
+        void draw(const Vertex* vertices, std::size_t vertex_count, const std::uint16_t* indices,
+                  std::size_t index_count, const SoftwareShading& shading);
+        void draw(const Vertex* vertices, std::size_t vertex_count, const std::uint32_t* indices,
+                  std::size_t index_count, const SoftwareShading& shading);
+
+        // Pixel (x, y) with y = 0 at the top, and its window-space depth in [0, 1]
+        std::array<std::uint8_t, 3> get_pixel(int x, int y) const;
+        float get_depth(int x, int y) const;
+        // Tightly packed RGB8 rows, top row first
+        const std::vector<std::uint8_t>& get_pixels() const noexcept {
+            return m_color;
+        }
+
+      private:
+        // vertex after the vertex stage: clip-space position and the varyings of vertex_src
+        struct ClipVertex {
+            std::array<float, 4> clip;
+            math::Vector3 world;
+            math::Vector3 normal;
+            math::Vector3 color;
+            std::array<float, 2> uv;
+        };
+
+        // screen-space triangle, ready for edge-function rasterization
+        struct SetupTriangle {
+            // edge function i is a[i] * x + b[i] * y + c[i], positive inside and zero on the edge opposite vertex i
+            std::array<float, 3> a;
+            std::array<float, 3> b;
+            std::array<float, 3> c;
+            std::array<bool, 3> top_left;
+            float inv_area;
+            std::array<float, 3> depth;
+            std::array<float, 3> inv_w;
+            std::array<ClipVertex, 3> vertices;
+            int min_x;
+            int min_y;
+            int max_x;
+            int max_y;
+        };
+
+        // triangles set up by one job, and per tile the indices of those overlapping it
+        struct Bin {
+            std::vector<SetupTriangle> triangles;
+            std::vector<std::vector<std::uint32_t>> tiles;
+        };
+
+        int m_width;
+        int m_height;
+        int m_tiles_x;
+        int m_tiles_y;
+        jobs::JobSystem* m_jobs;
+        std::vector<std::uint8_t> m_color;
+        std::vector<float> m_depth;
+        // kept between draws so their capacity is reused
+        std::vector<ClipVertex> m_clip_vertices;
+        std::vector<Bin> m_bins;
+
+        template <typename Index>
+        void draw_indexed(const Vertex* vertices, std::size_t vertex_count, const Index* indices,
+                          std::size_t index_count, const SoftwareShading& shading);
+        void transform_vertices(const Vertex* vertices, std::size_t vertex_count, const SoftwareShading& shading);
+        static ClipVertex interpolate(const ClipVertex& from, const ClipVertex& to, float t);
+        void setup_triangle(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, Bin& bin) const;
+        void clip_and_setup(const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, Bin& bin) const;
+        // draws what the first bin_count bins hold for one tile
+        void rasterize_tile(std::size_t tile, std::size_t bin_count, const SoftwareShading& shading);
+        void rasterize(const SetupTriangle& triangle, int min_x, int min_y, int max_x, int max_y,
+                       const SoftwareShading& shading);
+        void shade_pixel(const SetupTriangle& triangle, int x, int y, const std::array<float, 3>& edges, float depth,
+                         const SoftwareShading& shading);
+    };
+
+} // namespace di_renderer::graphics
@@ -1,9 +1,13 @@
 // NOLINTBEGIN
 #include "Triangle.hpp"
 
+#include "Lighting.hpp"
+
+#include <array>
 #include <cstddef>
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 namespace di_renderer::graphics {
 
@@ -21,8 +25,9 @@ uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProjection;
 uniform mat3 uNormalMatrix;
+uniform vec3 uTint;
 void main() {
-    vColor = aColor;
+    vColor = aColor * uTint;
     vNormal = normalize(uNormalMatrix * aNormal);
     vUV = aUV;
     vWorldPos = vec3(uModel * vec4(aPos, 1.0));
@@ -86,14 +91,30 @@ void main() {
         return s;
     }
 
-    GLuint create_shader_program() {
+    ShaderProgram::ShaderProgram(GLuint program) : m_id(program) {
+        m_uniforms.model = glGetUniformLocation(program, "uModel");
+        m_uniforms.view = glGetUniformLocation(program, "uView");
+        m_uniforms.projection = glGetUniformLocation(program, "uProjection");
+        m_uniforms.normal_matrix = glGetUniformLocation(program, "uNormalMatrix");
+        m_uniforms.tint = glGetUniformLocation(program, "uTint");
+        m_uniforms.camera_pos = glGetUniformLocation(program, "uCameraPos");
+        m_uniforms.use_texture = glGetUniformLocation(program, "uUseTexture");
+        m_uniforms.texture = glGetUniformLocation(program, "uTexture");
+        m_uniforms.light_pos1 = glGetUniformLocation(program, "uLightPos1");
+        m_uniforms.light_color1 = glGetUniformLocation(program, "uLightColor1");
+        m_uniforms.light_pos2 = glGetUniformLocation(program, "uLightPos2");
+        m_uniforms.light_color2 = glGetUniformLocation(program, "uLightColor2");
+        m_uniforms.use_light2 = glGetUniformLocation(program, "uUseLight2");
+    }
+
+    ShaderProgram create_shader_program() {
         GLuint vs = compile_shader(GL_VERTEX_SHADER, vertex_src);
         if (vs == 0u)
-            return 0;
+            return {};
         GLuint fs = compile_shader(GL_FRAGMENT_SHADER, fragment_src);
         if (fs == 0u) {
             glDeleteShader(vs);
-            return 0;
+            return {};
         }
         GLuint prog = glCreateProgram();
         glAttachShader(prog, vs);
@@ -110,29 +131,19 @@ void main() {
         }
         glDeleteShader(vs);
         glDeleteShader(fs);
-        return prog;
+        if (prog == 0u)
+            return {};
+        return ShaderProgram(prog);
     }
 
-    void destroy_shader_program(GLuint program) {
-        if (program != 0u)
-            glDeleteProgram(program);
+    void destroy_shader_program(ShaderProgram& program) {
+        if (program.valid())
+            glDeleteProgram(program.id());
+        program = {};
     }
 
-    static GLuint g_vao = 0;
-    static GLuint g_vbo = 0;
-    static GLuint g_ebo = 0;
-
-    void init_mesh_batch() {
-        if (g_vao != 0)
-            return;
-        glGenVertexArrays(1, &g_vao);
-        glGenBuffers(1, &g_vbo);
-        glGenBuffers(1, &g_ebo);
-        glBindVertexArray(g_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, g_vbo);
-        glBufferData(GL_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, 0, nullptr, GL_DYNAMIC_DRAW);
+    // expects the target VAO and its GL_ARRAY_BUFFER to be bound
+    static void configure_vertex_layout() {
         glEnableVertexAttribArray(0);
         glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) 0);
         glEnableVertexAttribArray(1);
@@ -141,42 +152,182 @@ void main() {
         glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, normal));
         glEnableVertexAttribArray(3);
         glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), (void*) offsetof(Vertex, uv));
+    }
+
+    void MeshBuffer::upload(GLState& state, const Vertex* vertices, size_t vertex_count, const std::uint16_t* indices,
+                            size_t index_count) {
+        upload(state, vertices, vertex_count, indices, index_count, GL_UNSIGNED_SHORT, sizeof(std::uint16_t));
+    }
+
+    void MeshBuffer::upload(GLState& state, const Vertex* vertices, size_t vertex_count, const std::uint32_t* indices,
+                            size_t index_count) {
+        upload(state, vertices, vertex_count, indices, index_count, GL_UNSIGNED_INT, sizeof(std::uint32_t));
+    }
+
+    void MeshBuffer::upload(GLState& state, const Vertex* vertices, size_t vertex_count, const void* indices,
+                            size_t index_count, GLenum index_type, size_t index_size) {
+        if ((vertices == nullptr) || (indices == nullptr) || vertex_count == 0 || index_count == 0) {
+            m_index_count = 0;
+            return;
+        }
+        if (m_vao == 0) {
+            glGenVertexArrays(1, &m_vao);
+            glGenBuffers(1, &m_vbo);
+            glGenBuffers(1, &m_ebo);
+            state.bind_vertex_array(m_vao);
+            glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            configure_vertex_layout();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+        } else {
+            state.bind_vertex_array(m_vao);
+            glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+        }
+        glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(Vertex), vertices, GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * index_size, indices, GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
+        m_index_count = index_count;
+        m_index_type = index_type;
     }
 
-    void destroy_mesh_batch() {
-        if (g_ebo != 0u) {
-            glDeleteBuffers(1, &g_ebo);
-            g_ebo = 0;
+    void MeshBuffer::upload_edges(GLState& state, const unsigned int* indices, size_t index_count) {
+        if (m_vao == 0 || indices == nullptr || index_count == 0) {
+            m_edge_index_count = 0;
+            return;
         }
-        if (g_vbo != 0u) {
-            glDeleteBuffers(1, &g_vbo);
-            g_vbo = 0;
+        // a VAO owns its element buffer binding, so the edges get their own VAO over the same vertices
+        if (m_edge_vao == 0) {
+            glGenVertexArrays(1, &m_edge_vao);
+            glGenBuffers(1, &m_edge_ebo);
+            state.bind_vertex_array(m_edge_vao);
+            glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+            configure_vertex_layout();
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_edge_ebo);
+            glBindBuffer(GL_ARRAY_BUFFER, 0);
+        } else {
+            state.bind_vertex_array(m_edge_vao);
         }
-        if (g_vao != 0u) {
-            glDeleteVertexArrays(1, &g_vao);
-            g_vao = 0;
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * sizeof(unsigned int), indices, GL_STATIC_DRAW);
+        m_edge_index_count = index_count;
+    }
+
+    void MeshBuffer::draw(GLState& state) const {
+        if (m_vao == 0 || m_index_count == 0) {
+            return;
         }
+        state.bind_vertex_array(m_vao);
+        glDrawElements(GL_TRIANGLES, (GLsizei) m_index_count, m_index_type, nullptr);
     }
 
-    void draw_indexed_mesh(const Vertex* vertices, size_t vertex_count, const unsigned int* indices, size_t index_count,
-                           GLuint shader_program) {
-        if ((vertices == nullptr) || (indices == nullptr) || vertex_count == 0 || index_count == 0) {
+    void MeshBuffer::draw_edges(GLState& state) const {
+        if (m_edge_vao == 0 || m_edge_index_count == 0) {
             return;
         }
-        if (g_vao == 0 || g_vbo == 0 || g_ebo == 0) {
-            init_mesh_batch();
-        }
-        glBindVertexArray(g_vao);
-        glBindBuffer(GL_ARRAY_BUFFER, g_vbo);
-        glBufferData(GL_ARRAY_BUFFER, vertex_count * sizeof(Vertex), vertices, GL_DYNAMIC_DRAW);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, g_ebo);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, index_count * sizeof(unsigned int), indices, GL_DYNAMIC_DRAW);
-        glUseProgram(shader_program);
-        glDrawElements(GL_TRIANGLES, (GLsizei) index_count, GL_UNSIGNED_INT, nullptr);
-        glBindVertexArray(0);
-        glUseProgram(0);
+        state.bind_vertex_array(m_edge_vao);
+        glDrawElements(GL_LINES, (GLsizei) m_edge_index_count, GL_UNSIGNED_INT, nullptr);
+    }
+
+    void MeshBuffer::destroy() {
+        if (m_edge_ebo != 0u) {
+            glDeleteBuffers(1, &m_edge_ebo);
+            m_edge_ebo = 0;
+        }
+        if (m_edge_vao != 0u) {
+            glDeleteVertexArrays(1, &m_edge_vao);
+            m_edge_vao = 0;
+        }
+        m_edge_index_count = 0;
+        if (m_ebo != 0u) {
+            glDeleteBuffers(1, &m_ebo);
+            m_ebo = 0;
+        }
+        if (m_vbo != 0u) {
+            glDeleteBuffers(1, &m_vbo);
+            m_vbo = 0;
+        }
+        if (m_vao != 0u) {
+            glDeleteVertexArrays(1, &m_vao);
+            m_vao = 0;
+        }
+        m_index_count = 0;
+    }
+
+    std::vector<Vertex> get_mesh_vertices(const core::IndexedMesh& mesh, bool flip_uv_y) {
+        std::vector<Vertex> vertices;
+        vertices.reserve(mesh.vertices().size());
+
+        for (const auto& source : mesh.vertices()) {
+            Vertex vertex{};
+            vertex.position = {source.position.x, source.position.y, source.position.z};
+            vertex.color = {1.0f, 1.0f, 1.0f};
+            vertex.normal = {source.normal.x, source.normal.y, source.normal.z};
+            vertex.uv = {source.uv.u, flip_uv_y ? (1.0f - source.uv.v) : source.uv.v};
+            vertices.push_back(vertex);
+        }
+        return vertices;
+    }
+
+    size_t AssembledMesh::get_upload_size() const noexcept {
+        const size_t index_size = indexed.has_16bit_indices() ? sizeof(std::uint16_t) : sizeof(std::uint32_t);
+        return (vertices.size() * sizeof(Vertex)) + (indexed.index_count() * index_size) +
+               (edges.size() * sizeof(std::uint32_t));
+    }
+
+    AssembledMesh assemble_mesh(const core::Mesh& mesh, bool flip_uv_y) {
+        core::IndexedMesh indexed(mesh);
+        std::vector<Vertex> vertices = get_mesh_vertices(indexed, flip_uv_y);
+        std::vector<std::uint32_t> edges = indexed.get_edge_indices(mesh.faces);
+        return {std::move(indexed), std::move(vertices), std::move(edges)};
+    }
+
+    void upload_assembled_mesh(GLState& state, MeshBuffer& buffer, const AssembledMesh& mesh) {
+        const core::IndexedMesh& indexed = mesh.indexed;
+        const std::vector<Vertex>& vertices = mesh.vertices;
+        if (indexed.has_16bit_indices()) {
+            buffer.upload(state, vertices.data(), vertices.size(), indexed.indices16().data(), indexed.index_count());
+        } else {
+            buffer.upload(state, vertices.data(), vertices.size(), indexed.indices32().data(), indexed.index_count());
+        }
+        buffer.upload_edges(state, mesh.edges.data(), mesh.edges.size());
+    }
+
+    void upload_mesh(GLState& state, MeshBuffer& buffer, const core::Mesh& mesh, bool flip_uv_y) {
+        upload_assembled_mesh(state, buffer, assemble_mesh(mesh, flip_uv_y));
+    }
+
+    void set_model_uniforms(const ShaderUniforms& uniforms, const math::Transform& transform) {
+        const math::Matrix4x4& model_matrix = transform.get_matrix();
+        const math::Matrix4x4& normal_matrix = transform.get_normal_matrix();
+
+        // upper-left 3x3 of the column-major inverse-transpose
+        const std::array<GLfloat, 9> normal_matrix_3x3 = {
+            normal_matrix(0, 0), normal_matrix(1, 0), normal_matrix(2, 0), normal_matrix(0, 1), normal_matrix(1, 1),
+            normal_matrix(2, 1), normal_matrix(0, 2), normal_matrix(1, 2), normal_matrix(2, 2)};
+
+        if (uniforms.model != -1) {
+            glUniformMatrix4fv(uniforms.model, 1, GL_FALSE, model_matrix.data());
+        }
+        if (uniforms.normal_matrix != -1) {
+            glUniformMatrix3fv(uniforms.normal_matrix, 1, GL_FALSE, normal_matrix_3x3.data());
+        }
+    }
+
+    void set_camera_uniforms(const ShaderUniforms& uniforms, const math::Camera& camera) {
+        if (uniforms.view != -1) {
+            glUniformMatrix4fv(uniforms.view, 1, GL_FALSE, camera.get_view_matrix().data());
+        }
+        if (uniforms.projection != -1) {
+            glUniformMatrix4fv(uniforms.projection, 1, GL_FALSE, camera.get_projection_matrix().data());
+        }
+
+        const math::Vector3 camera_pos = camera.get_position();
+        if (uniforms.camera_pos != -1) {
+            glUniform3f(uniforms.camera_pos, camera_pos.x, camera_pos.y, camera_pos.z);
+        }
+
+        const math::Vector3 light1_pos = get_camera_light_position(camera);
+        if (uniforms.light_pos1 != -1) {
+            glUniform3f(uniforms.light_pos1, light1_pos.x, light1_pos.y, light1_pos.z);
+        }
     }
 
 } // namespace di_renderer::graphics
@@ -1,25 +1,122 @@
 #pragma once
 
-#include <array>
+#include "GLState.hpp"
+#include "Vertex.hpp"
+#include "core/IndexedMesh.hpp"
+#include "core/Mesh.hpp"
+#include "math/Camera.hpp"
+#include "math/Transform.hpp"
+
 #include <cstddef>
+#include <cstdint>
 #include <epoxy/gl.h>
+#include <vector>
 
 namespace di_renderer::graphics {
 
-    struct Vertex {
-        std::array<float, 3> position;
-        std::array<float, 3> color;
-        std::array<float, 3> normal;
-        std::array<float, 2> uv;
+    // Uniform locations of the built-in shader, -1 for uniforms the linker dropped
+    struct ShaderUniforms {
+        GLint model = -1;
+        GLint view = -1;
+        GLint projection = -1;
+        GLint normal_matrix = -1;
+        GLint tint = -1;
+        GLint camera_pos = -1;
+        GLint use_texture = -1;
+        GLint texture = -1;
+        GLint light_pos1 = -1;
+        GLint light_color1 = -1;
+        GLint light_pos2 = -1;
+        GLint light_color2 = -1;
+        GLint use_light2 = -1;
     };
 
-    GLuint create_shader_program();
-    void destroy_shader_program(GLuint program);
+    // Linked program together with its uniform locations, looked up once instead of by name on every draw
+    class ShaderProgram {
+      public:
+        ShaderProgram() = default;
+        explicit ShaderProgram(GLuint program);
+
+        GLuint id() const noexcept {
+            return m_id;
+        }
+        bool valid() const noexcept {
+            return m_id != 0;
+        }
+        const ShaderUniforms& uniforms() const noexcept {
+            return m_uniforms;
+        }
+
+      private:
+        GLuint m_id = 0;
+        ShaderUniforms m_uniforms;
+    };
+
+    // Returns an invalid program if compiling or linking fails, the log is printed to stderr
+    ShaderProgram create_shader_program();
+    void destroy_shader_program(ShaderProgram& program);
+
+    // Vertex/index buffers of a single mesh, uploaded once with static usage and drawn as-is every frame.
+    // GL names are released only through destroy(), which must run while the owning context is current.
+    class MeshBuffer {
+      public:
+        // Triangle list, 16-bit indices halve the index buffer for meshes with at most 65536 vertices
+        void upload(GLState& state, const Vertex* vertices, size_t vertex_count, const std::uint16_t* indices,
+                    size_t index_count);
+        void upload(GLState& state, const Vertex* vertices, size_t vertex_count, const std::uint32_t* indices,
+                    size_t index_count);
+        // Index pairs of the mesh's unique edges, drawn as GL_LINES over the vertices passed to upload()
+        void upload_edges(GLState& state, const unsigned int* indices, size_t index_count);
+        // draw/draw_edges use the current program
+        void draw(GLState& state) const;
+        void draw_edges(GLState& state) const;
+        // must not be called while one of the buffer's VAOs is bound through a GLState
+        void destroy();
+
+        bool empty() const noexcept {
+            return m_index_count == 0;
+        }
+        size_t get_triangle_count() const noexcept {
+            return m_index_count / 3;
+        }
+        size_t get_edge_count() const noexcept {
+            return m_edge_index_count / 2;
+        }
 
-    void init_mesh_batch();
-    void destroy_mesh_batch();
+      private:
+        void upload(GLState& state, const Vertex* vertices, size_t vertex_count, const void* indices,
+                    size_t index_count, GLenum index_type, size_t index_size);
+
+        GLuint m_vao = 0;
+        GLuint m_vbo = 0;
+        GLuint m_ebo = 0;
+        size_t m_index_count = 0;
+        GLenum m_index_type = GL_UNSIGNED_INT;
+        GLuint m_edge_vao = 0;
+        GLuint m_edge_ebo = 0;
+        size_t m_edge_index_count = 0;
+    };
+
+    // Vertices of the built-in shader's layout, white. flip_uv_y mirrors v for textures stored top row first.
+    std::vector<Vertex> get_mesh_vertices(const core::IndexedMesh& mesh, bool flip_uv_y);
+
+    // CPU side of upload_mesh: the welded mesh, its vertices in the shader layout and its edge index pairs
+    struct AssembledMesh {
+        core::IndexedMesh indexed;
+        std::vector<Vertex> vertices;
+        std::vector<std::uint32_t> edges;
+
+        // bytes upload_assembled_mesh sends to the GPU
+        size_t get_upload_size() const noexcept;
+    };
+    AssembledMesh assemble_mesh(const core::Mesh& mesh, bool flip_uv_y);
+    void upload_assembled_mesh(GLState& state, MeshBuffer& buffer, const AssembledMesh& mesh);
+    // Welds mesh into shared corners and uploads its triangles and edges to buffer
+    void upload_mesh(GLState& state, MeshBuffer& buffer, const core::Mesh& mesh, bool flip_uv_y);
 
-    void draw_indexed_mesh(const Vertex* vertices, size_t vertex_count, const unsigned int* indices, size_t index_count,
-                           GLuint shader_program);
+    // Uniform setters for the current program: model and normal matrix of a transform, and the view, projection,
+    // camera position and camera-attached light of a camera
+    void set_model_uniforms(const ShaderUniforms& uniforms, const math::Transform& transform);
+    void set_camera_uniforms(const ShaderUniforms& uniforms, const math::Camera& camera);
 
 } // namespace di_renderer::graphics
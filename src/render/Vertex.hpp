@@ -0,0 +1,15 @@
+#pragma once
+
+#include <array>
+
+namespace di_renderer::graphics {
+
+    // Vertex layout of the built-in shader, shared by the GL and the software backend
+    struct Vertex {
+        std::array<float, 3> position;
+        std::array<float, 3> color;
+        std::array<float, 3> normal;
+        std::array<float, 2> uv;
+    };
+
+} // namespace di_renderer::graphics
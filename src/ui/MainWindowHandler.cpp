@@ -3,13 +3,14 @@
 #include "TransformTypeHelper.hpp"
 #include "core/AppData.hpp"
 #include "core/Mesh.hpp"
-#include "io/ObjReader.hpp"
 #include "io/ObjWriter.hpp"
 #include "render/OpenGLArea.hpp"
 
 #include <cassert>
+#include <exception>
 #include <gtkmm.h>
 #include <iostream>
+#include <utility>
 
 using di_renderer::render::OpenGLArea;
 using di_renderer::ui::MainWindowHandler;
@@ -22,6 +23,11 @@ MainWindowHandler::MainWindowHandler() {
     init_error_handling();
 }
 
+MainWindowHandler::~MainWindowHandler() {
+    // the timeout captures this
+    m_stats_refresh.disconnect();
+}
+
 void MainWindowHandler::show(Gtk::Application& app) const {
     app.add_window(*m_window);
     m_window->show_all();
@@ -59,6 +65,7 @@ void MainWindowHandler::load_ui() {
     connect_buttons();
     connect_entries();
     init_gl_area();
+    init_model_loader();
     m_builder->get_widget("model_index", m_model_index_label);
     m_camera_selection_handler.init(m_builder, m_gl_area->get_app_data());
 }
@@ -87,6 +94,12 @@ void MainWindowHandler::connect_buttons() {
             [this, toggle_button, mode = render_mode] { on_render_toggle_button_click(*toggle_button, mode); });
     }
 
+    // frame stats overlay and its report
+    m_builder->get_widget("button_toggle_stats", toggle_button);
+    toggle_button->signal_toggled().connect([this, toggle_button] { on_stats_toggle(toggle_button->get_active()); });
+    m_builder->get_widget("button_save_stats", m_save_stats_button);
+    m_save_stats_button->signal_clicked().connect([this] { on_save_stats_button_click(); });
+
     // texture selector
     m_builder->get_widget("texture_file_selector", m_texture_selector);
     m_texture_selector->signal_file_set().connect([this] { on_texture_selection(); });
@@ -146,17 +159,54 @@ void MainWindowHandler::init_error_handling() const {
 void MainWindowHandler::init_gl_area() {
     m_gl_area = Gtk::make_managed<OpenGLArea>();
 
+    // frame stats are drawn over the top-left corner of the viewport, hidden until the stats button is toggled
+    auto* const overlay = Gtk::make_managed<Gtk::Overlay>();
+    overlay->add(*m_gl_area);
+    m_stats_label = Gtk::make_managed<Gtk::Label>();
+    m_stats_label->set_halign(Gtk::ALIGN_START);
+    m_stats_label->set_valign(Gtk::ALIGN_START);
+    m_stats_label->set_margin_start(8);
+    m_stats_label->set_margin_top(8);
+    m_stats_label->set_no_show_all(true);
+    m_stats_label->get_style_context()->add_class("osd");
+    overlay->add_overlay(*m_stats_label);
+
     Gtk::Widget* placeholder_box = nullptr;
     m_builder->get_widget("gl_placeholder", placeholder_box);
 
     if (auto* const box = dynamic_cast<Gtk::Box*>(placeholder_box)) {
-        box->pack_start(*m_gl_area);
+        box->pack_start(*overlay);
     } else {
         std::cerr << "Error: Box is not a Gtk::Box" << '\n';
     }
 }
 
-void MainWindowHandler::on_open_button_click() const {
+void MainWindowHandler::init_model_loader() {
+    m_builder->get_widget("load_progress", m_load_progress);
+    m_model_loader.init(
+        [this](core::Mesh&& mesh) {
+            m_gl_area->get_app_data().add_mesh(std::move(mesh));
+            update_entries();
+        },
+        // rethrown from an idle handler so it reaches the regular error dialog
+        [](const std::exception_ptr& error) {
+            Glib::signal_idle().connect_once([error] { std::rethrow_exception(error); });
+        },
+        [this](const std::size_t pending, const float progress) { on_model_load_progress(pending, progress); });
+}
+
+void MainWindowHandler::on_model_load_progress(const std::size_t pending, const float progress) const {
+    if (pending == 0) {
+        m_load_progress->hide();
+        return;
+    }
+
+    m_load_progress->set_fraction(progress);
+    m_load_progress->set_text(pending == 1 ? "Loading model" : "Loading " + std::to_string(pending) + " models");
+    m_load_progress->show();
+}
+
+void MainWindowHandler::on_open_button_click() {
     auto dialog =
         Gtk::FileChooserNative::create("Select model", *m_window, Gtk::FILE_CHOOSER_ACTION_OPEN, "_Open", "_Cancel");
 
@@ -167,11 +217,7 @@ void MainWindowHandler::on_open_button_click() const {
 
     dialog->signal_response().connect([this, dialog](const int response_id) {
         if (response_id == Gtk::RESPONSE_ACCEPT) {
-            const auto filename = dialog->get_filename();
-            const auto [vertices, texture_vertices, normals, faces] = io::ObjReader::read_file(filename);
-            core::Mesh mesh{vertices, texture_vertices, normals, faces};
-            m_gl_area->get_app_data().add_mesh(std::move(mesh));
-            update_entries();
+            m_model_loader.load(dialog->get_filename());
         }
     });
 
@@ -191,13 +237,55 @@ void MainWindowHandler::on_save_button_click() const {
         if (response_id == Gtk::RESPONSE_ACCEPT) {
             const auto& filename = dialog->get_filename();
             const auto& mesh = m_gl_area->get_app_data().get_current_mesh();
-            io::ObjWriter::write_file(filename, mesh);
+            io::ObjWriter::write_file(filename, mesh, false, {0, true});
+        }
+    });
+
+    dialog->show();
+}
+
+void MainWindowHandler::on_stats_toggle(const bool active) {
+    m_gl_area->set_profiling_enabled(active);
+    m_save_stats_button->set_sensitive(active);
+    m_stats_label->set_visible(active);
+    m_stats_refresh.disconnect();
+    if (active) {
+        update_stats_overlay();
+        m_stats_refresh = Glib::signal_timeout().connect(
+            [this] {
+                update_stats_overlay();
+                // the area only draws on demand, without this an idle scene records no new frames
+                m_gl_area->request_render();
+                return true;
+            },
+            STATS_REFRESH_MS);
+    }
+}
+
+void MainWindowHandler::on_save_stats_button_click() const {
+    auto dialog = Gtk::FileChooserNative::create("Save frame stats", *m_window, Gtk::FILE_CHOOSER_ACTION_SAVE,
+                                                 "_Save", "_Cancel");
+
+    const auto filter = Gtk::FileFilter::create();
+    filter->set_name("CSV files");
+    filter->add_pattern("*.csv");
+    dialog->set_filter(filter);
+    dialog->set_current_name("frame_stats.csv");
+
+    dialog->signal_response().connect([this, dialog](const int response_id) {
+        if (response_id == Gtk::RESPONSE_ACCEPT) {
+            m_gl_area->get_frame_profiler().write_report(dialog->get_filename());
         }
     });
 
     dialog->show();
 }
 
+void MainWindowHandler::update_stats_overlay() const {
+    m_stats_label->set_markup("<tt>" + Glib::Markup::escape_text(m_gl_area->get_frame_profiler().format_summary()) +
+                              "</tt>");
+}
+
 void MainWindowHandler::on_close_button_click() const {
     auto& app_data = m_gl_area->get_app_data();
     app_data.remove_current_mesh();
@@ -207,6 +295,7 @@ void MainWindowHandler::on_close_button_click() const {
 void MainWindowHandler::on_texture_selection() const {
     auto& mesh = m_gl_area->get_app_data().get_current_mesh();
     mesh.load_texture(m_texture_selector->get_filename());
+    m_gl_area->request_render();
 }
 
 void MainWindowHandler::on_render_toggle_button_click(const Gtk::ToggleButton& btn, const core::RenderMode mode) {
@@ -249,4 +338,5 @@ void MainWindowHandler::on_transform_entry_activate(Gtk::Entry& entry, const std
         transform.set_scale(get_new_vector(transform.get_scale(), transform_type.component, value));
         break;
     }
+    m_gl_area->request_render();
 }
@@ -1,5 +1,6 @@
 #pragma once
 #include "CameraSelectionHandler.hpp"
+#include "ModelLoader.hpp"
 #include "core/RenderMode.hpp"
 #include "render/OpenGLArea.hpp"
 
@@ -9,6 +10,11 @@ namespace di_renderer::ui {
     class MainWindowHandler final {
       public:
         MainWindowHandler();
+        ~MainWindowHandler();
+        MainWindowHandler(const MainWindowHandler&) = delete;
+        MainWindowHandler& operator=(const MainWindowHandler&) = delete;
+        MainWindowHandler(MainWindowHandler&&) = delete;
+        MainWindowHandler& operator=(MainWindowHandler&&) = delete;
 
         void show(Gtk::Application& app) const;
         void update_entries() const;
@@ -19,11 +25,14 @@ namespace di_renderer::ui {
             {"button_toggle_polygons", core::RenderMode::POLYGON},
             {"button_toggle_texture", core::RenderMode::TEXTURE},
             {"button_toggle_lighting", core::RenderMode::LIGHTING}};
+        // how often the frame stats overlay is refreshed while shown, each refresh also renders a frame to measure
+        static constexpr unsigned int STATS_REFRESH_MS = 500;
         inline static const std::array<std::string, 9> TRANSFORM_IDS = {
             "translation_x", "translation_y", "translation_z", "rotation_x", "rotation_y",
             "rotation_z",    "scale_x",       "scale_y",       "scale_z"};
 
         CameraSelectionHandler m_camera_selection_handler;
+        ModelLoader m_model_loader;
         Glib::RefPtr<Gtk::Builder> m_builder;
         Gtk::Window* m_window{nullptr};
         Gtk::FileChooserButton* m_texture_selector{nullptr};
@@ -33,6 +42,10 @@ namespace di_renderer::ui {
         Gtk::Button* m_prev_model_button{nullptr};
         Gtk::Button* m_next_model_button{nullptr};
         Gtk::Button* m_close_button{nullptr};
+        Gtk::ProgressBar* m_load_progress{nullptr};
+        Gtk::Label* m_stats_label{nullptr};
+        Gtk::Button* m_save_stats_button{nullptr};
+        sigc::connection m_stats_refresh;
 
         std::array<Gtk::Entry*, 9> m_transform_entries{};
 
@@ -41,9 +54,14 @@ namespace di_renderer::ui {
         void connect_entries();
         void init_error_handling() const;
         void init_gl_area();
-        void on_open_button_click() const;
+        void init_model_loader();
+        void on_open_button_click();
+        void on_model_load_progress(std::size_t pending, float progress) const;
         void on_save_button_click() const;
         void on_close_button_click() const;
+        void on_stats_toggle(bool active);
+        void on_save_stats_button_click() const;
+        void update_stats_overlay() const;
         void on_texture_selection() const;
         void on_render_toggle_button_click(const Gtk::ToggleButton& btn, core::RenderMode mode);
         void on_transform_entry_activate(Gtk::Entry& entry, const std::string& entry_id);
@@ -0,0 +1,85 @@
+#include "ModelLoader.hpp"
+
+#include "io/MeshCache.hpp"
+
+#include <stdexcept>
+#include <utility>
+
+using di_renderer::ui::ModelLoader;
+
+ModelLoader::ModelLoader() {
+    m_dispatcher.connect(sigc::mem_fun(*this, &ModelLoader::on_dispatch));
+}
+
+ModelLoader::~ModelLoader() {
+    // the progress callback throws once this is set, so running loads stop at their next report or phase boundary
+    m_cancelled.store(true);
+    for (const auto& job : m_jobs) {
+        if (job->worker.joinable()) {
+            job->worker.join();
+        }
+    }
+}
+
+void ModelLoader::init(LoadedSlot on_loaded, FailedSlot on_failed, ProgressSlot on_progress) {
+    m_on_loaded = std::move(on_loaded);
+    m_on_failed = std::move(on_failed);
+    m_on_progress = std::move(on_progress);
+}
+
+void ModelLoader::load(const std::string& filename) {
+    auto& job = m_jobs.emplace_back(std::make_unique<Job>());
+    job->filename = filename;
+    try {
+        job->worker = std::thread([this, &job = *job] { run(job); });
+    } catch (...) {
+        // a job without a worker would never finish
+        m_jobs.pop_back();
+        throw;
+    }
+    on_dispatch();
+}
+
+void ModelLoader::run(Job& job) {
+    try {
+        job.mesh = io::MeshCache::load_or_read(job.filename, [this, &job](const float progress) {
+            if (m_cancelled.load(std::memory_order_relaxed)) {
+                throw std::runtime_error("Loading cancelled");
+            }
+            job.progress.store(progress, std::memory_order_relaxed);
+            m_dispatcher.emit();
+        });
+    } catch (...) {
+        job.error = std::current_exception();
+    }
+    job.finished.store(true, std::memory_order_release);
+    m_dispatcher.emit();
+}
+
+void ModelLoader::on_dispatch() {
+    for (auto it = m_jobs.begin(); it != m_jobs.end();) {
+        if (!(*it)->finished.load(std::memory_order_acquire)) {
+            ++it;
+            continue;
+        }
+
+        const std::unique_ptr<Job> job = std::move(*it);
+        it = m_jobs.erase(it);
+        job->worker.join();
+        if (job->error) {
+            if (m_on_failed) {
+                m_on_failed(job->error);
+            }
+        } else if (m_on_loaded) {
+            m_on_loaded(std::move(*job->mesh));
+        }
+    }
+
+    if (m_on_progress) {
+        float total = 0.0f;
+        for (const auto& job : m_jobs) {
+            total += job->progress.load(std::memory_order_relaxed);
+        }
+        m_on_progress(m_jobs.size(), m_jobs.empty() ? 1.0f : total / static_cast<float>(m_jobs.size()));
+    }
+}
@@ -0,0 +1,58 @@
+#pragma once
+#include "core/Mesh.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <glibmm/dispatcher.h>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+
+namespace di_renderer::ui {
+    // Loads models on worker threads, one per file, and reports back on the main loop through a Glib::Dispatcher.
+    // Several loads can be in flight at once, finished meshes are handed over in completion order.
+    class ModelLoader final {
+      public:
+        using LoadedSlot = std::function<void(core::Mesh&& mesh)>;
+        using FailedSlot = std::function<void(std::exception_ptr error)>;
+        // pending is the number of loads still running, progress their average completion in [0, 1]
+        using ProgressSlot = std::function<void(std::size_t pending, float progress)>;
+
+        ModelLoader();
+        ~ModelLoader();
+        ModelLoader(const ModelLoader&) = delete;
+        ModelLoader& operator=(const ModelLoader&) = delete;
+        ModelLoader(ModelLoader&&) = delete;
+        ModelLoader& operator=(ModelLoader&&) = delete;
+
+        void init(LoadedSlot on_loaded, FailedSlot on_failed, ProgressSlot on_progress);
+        void load(const std::string& filename);
+
+      private:
+        struct Job {
+            std::string filename;
+            std::thread worker;
+            std::atomic<float> progress{0.0f};
+            std::atomic<bool> finished{false};
+            // written by the worker before finished is set, read on the main loop after
+            std::optional<core::Mesh> mesh;
+            std::exception_ptr error;
+        };
+
+        // only touched on the main loop, workers access nothing but their own Job
+        std::list<std::unique_ptr<Job>> m_jobs;
+        std::atomic<bool> m_cancelled{false};
+        Glib::Dispatcher m_dispatcher;
+
+        LoadedSlot m_on_loaded;
+        FailedSlot m_on_failed;
+        ProgressSlot m_on_progress;
+
+        void run(Job& job);
+        void on_dispatch();
+    };
+} // namespace di_renderer::ui
@@ -1,11 +1,16 @@
 #include "core/AppData.hpp"
+#include "core/FaceList.hpp"
 #include "core/FaceVerticeData.hpp"
+#include "core/IndexedMesh.hpp"
+#include "jobs/JobSystem.hpp"
 #include "math/Camera.hpp"
 #include "math/UVCoord.hpp"
 #include "math/Vector3.hpp"
 
+#include <cmath>
 #include <core/Mesh.hpp>
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 using di_renderer::core::AppData;
 using di_renderer::core::Mesh;
@@ -172,7 +177,7 @@ TEST(MeshTriangulationTest, TriangleFaceRemainsUnchanged) {
     const std::vector<di_renderer::math::UVCoord> tex_coords = {{0, 0}, {1, 0}, {0, 1}};
     const std::vector<di_renderer::math::Vector3> normals = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {{{0, 0, 0}, {1, 1, 1}, {2, 2, 2}}};
+    const di_renderer::core::FaceList faces = {{{0, 0, 0}, {1, 1, 1}, {2, 2, 2}}};
 
     Mesh mesh(vertices, tex_coords, normals, faces);
 
@@ -188,7 +193,7 @@ TEST(MeshTriangulationTest, QuadFaceTriangulatesToTwoTriangles) {
     const std::vector<di_renderer::math::UVCoord> tex_coords = {{0, 0}, {1, 0}, {1, 1}, {0, 1}};
     const std::vector<di_renderer::math::Vector3> normals = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3}}};
 
     Mesh mesh(vertices, tex_coords, normals, faces);
@@ -211,7 +216,7 @@ TEST(MeshTriangulationTest, PentagonFaceTriangulatesToThreeTriangles) {
     const std::vector<di_renderer::math::UVCoord> tex_coords = {{0, 0}, {1, 0}, {2, 1}, {1, 2}, {0, 1}};
     const std::vector<di_renderer::math::Vector3> normals = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3}, {4, 4, 4}}};
 
     Mesh mesh(vertices, tex_coords, normals, faces);
@@ -239,7 +244,7 @@ TEST(MeshTriangulationTest, SingleFaceWithLessThanThreeVerticesIgnored) {
     const std::vector<di_renderer::math::UVCoord> tex_coords = {{0, 0}, {1, 0}};
     const std::vector<di_renderer::math::Vector3> normals = {{0, 0, 1}, {0, 0, 1}};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {{
+    const di_renderer::core::FaceList faces = {{
         {0, 0, 0}, {1, 1, 1} // Only 2 vertices
     }};
 
@@ -253,7 +258,7 @@ TEST(MeshTriangulationTest, MultipleFacesAllTriangulated) {
     const std::vector<di_renderer::math::UVCoord> tex_coords = {{0, 0}, {1, 0}, {1, 1}, {0, 1}, {2, 0}};
     const std::vector<di_renderer::math::Vector3> normals = {{0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}, {0, 0, 1}};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, 0, 0}, {1, 1, 1}, {2, 2, 2}},           // Triangle
         {{0, 0, 0}, {1, 1, 1}, {2, 2, 2}, {3, 3, 3}} // Quad
     };
@@ -270,7 +275,7 @@ TEST(MeshNormalComputationTest, ProvidedNormalsArePreserved) {
     auto provided_normals = {di_renderer::math::Vector3(0.0f, 0.0f, 1.0f), di_renderer::math::Vector3(0.0f, 0.0f, 1.0f),
                              di_renderer::math::Vector3(0.0f, 0.0f, 1.0f)};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}};
 
     Mesh mesh(vertices, {}, provided_normals, faces);
@@ -291,7 +296,7 @@ TEST(MeshNormalComputationTest, SingleTriangleNormalComputation) {
     auto vertices = {di_renderer::math::Vector3(0.0f, 0.0f, 0.0f), di_renderer::math::Vector3(1.0f, 0.0f, 0.0f),
                      di_renderer::math::Vector3(0.0f, 1.0f, 0.0f)};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}};
 
     Mesh mesh(vertices, {}, {}, faces);
@@ -308,7 +313,7 @@ TEST(MeshNormalComputationTest, SingleTriangleNormalComputation) {
 TEST(MeshNormalComputationTest, InvalidIndicesHandling) {
     auto vertices = {di_renderer::math::Vector3(0.0f, 0.0f, 0.0f), di_renderer::math::Vector3(1.0f, 0.0f, 0.0f)};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, -1, -1}, {1, -1, -1}, {99, -1, -1}}};
 
     const Mesh mesh(vertices, {}, {}, faces);
@@ -319,7 +324,7 @@ TEST(MeshNormalComputationTest, NormalNormalization) {
     auto vertices = {di_renderer::math::Vector3(0.0f, 0.0f, 0.0f), di_renderer::math::Vector3(2.0f, 0.0f, 0.0f),
                      di_renderer::math::Vector3(0.0f, 2.0f, 0.0f)};
 
-    const std::vector<std::vector<di_renderer::core::FaceVerticeData>> faces = {
+    const di_renderer::core::FaceList faces = {
         {{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}};
 
     const Mesh mesh(vertices, {}, {}, faces);
@@ -328,3 +333,247 @@ TEST(MeshNormalComputationTest, NormalNormalization) {
         EXPECT_NEAR(normal.length(), 1.0f, EPS);
     }
 }
+
+TEST(MeshNormalComputationTest, WeightingModes) {
+    using di_renderer::core::NormalWeighting;
+    using di_renderer::math::Vector3;
+
+    // vertex 0 is shared by a large +Z triangle and a small +Y one with a 45 degree corner
+    Mesh mesh({{0, 0, 0}, {2, 0, 0}, {0, 2, 0}, {0, 0, 1}, {1, 0, 1}}, {}, {},
+              {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}, {{0, -1, -1}, {3, -1, -1}, {4, -1, -1}}});
+    const auto expect_normal = [&](const Vector3& expected) {
+        const Vector3 normal = mesh.normals[0];
+        const Vector3 unit = expected.normalized();
+        EXPECT_NEAR(normal.x, unit.x, 1e-6f);
+        EXPECT_NEAR(normal.y, unit.y, 1e-6f);
+        EXPECT_NEAR(normal.z, unit.z, 1e-6f);
+    };
+
+    mesh.compute_vertex_normals();
+    expect_normal({0, 1, 4});
+    mesh.compute_vertex_normals(NormalWeighting::UNIFORM);
+    expect_normal({0, 1, 1});
+    mesh.compute_vertex_normals(NormalWeighting::ANGLE);
+    expect_normal({0, 1, 2});
+}
+
+TEST(MeshNormalComputationTest, LargeMeshMatchesSerialReference) {
+    using di_renderer::core::FaceList;
+    using di_renderer::math::Vector3;
+
+    // 90000 vertices, more than two chunks of the normals pass, on a pool that actually splits them
+    const std::size_t thread_count = di_renderer::jobs::JobSystem::global().get_thread_count();
+    di_renderer::jobs::JobSystem::set_global_thread_count(4);
+    constexpr int SIZE = 300;
+    std::vector<Vector3> vertices;
+    for (int y = 0; y < SIZE; ++y) {
+        for (int x = 0; x < SIZE; ++x) {
+            const float height = std::sin(0.1f * static_cast<float>(x * y));
+            vertices.emplace_back(static_cast<float>(x), static_cast<float>(y), height);
+        }
+    }
+    FaceList faces;
+    for (int y = 0; y + 1 < SIZE; ++y) {
+        for (int x = 0; x + 1 < SIZE; ++x) {
+            const int i = (y * SIZE) + x;
+            faces.push_back({{i, -1, -1}, {i + 1, -1, -1}, {i + SIZE + 1, -1, -1}, {i + SIZE, -1, -1}});
+        }
+    }
+    Mesh mesh(vertices, {}, {}, faces);
+    mesh.compute_vertex_normals();
+
+    std::vector<Vector3> expected(vertices.size());
+    for (const auto face : mesh.faces) {
+        const Vector3& v0 = vertices[face[0].vi];
+        const Vector3 normal = (vertices[face[1].vi] - v0).cross(vertices[face[2].vi] - v0);
+        for (std::size_t k = 0; k < 3; ++k) {
+            expected[face[k].vi] = expected[face[k].vi] + normal;
+        }
+    }
+    ASSERT_EQ(mesh.normals.size(), expected.size());
+    for (std::size_t i = 0; i < expected.size(); ++i) {
+        const Vector3 unit = expected[i].normalized();
+        EXPECT_NEAR(mesh.normals[i].x, unit.x, 1e-6f);
+        EXPECT_NEAR(mesh.normals[i].y, unit.y, 1e-6f);
+        EXPECT_NEAR(mesh.normals[i].z, unit.z, 1e-6f);
+    }
+    di_renderer::jobs::JobSystem::set_global_thread_count(thread_count);
+}
+
+TEST(MeshRevisionTest, GeometryEditsChangeRevision) {
+    Mesh mesh({{0, 0, 0}, {1, 0, 0}, {0, 1, 0}}, {}, {}, {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}});
+    const Mesh copy = mesh;
+    const Mesh other;
+
+    EXPECT_EQ(copy.get_geometry_revision(), mesh.get_geometry_revision());
+    EXPECT_NE(other.get_geometry_revision(), mesh.get_geometry_revision());
+
+    const auto revision = mesh.get_geometry_revision();
+    mesh.compute_vertex_normals();
+    EXPECT_NE(mesh.get_geometry_revision(), revision);
+
+    const auto recomputed_revision = mesh.get_geometry_revision();
+    mesh.mark_geometry_dirty();
+    EXPECT_NE(mesh.get_geometry_revision(), recomputed_revision);
+    EXPECT_NE(mesh.get_geometry_revision(), copy.get_geometry_revision());
+}
+
+TEST(MeshBoundsTest, BoundsFollowGeometryAndTransform) {
+    using di_renderer::math::Vector3;
+
+    AppData app_data;
+    EXPECT_TRUE(app_data.get_scene_bounds().is_empty());
+
+    Mesh mesh({{0, 0, 0}, {1, 2, 0}, {0, 1, 3}}, {}, {}, {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}});
+    EXPECT_EQ(mesh.get_local_bounds().max, Vector3(1, 2, 3));
+
+    mesh.vertices.emplace_back(-4, 0, 0);
+    EXPECT_EQ(mesh.get_local_bounds().min, Vector3(0, 0, 0)); // not marked dirty yet
+    mesh.mark_geometry_dirty();
+    EXPECT_EQ(mesh.get_local_bounds().min, Vector3(-4, 0, 0));
+
+    mesh.get_transform().set_position(Vector3(10, 0, 0));
+    EXPECT_EQ(mesh.get_world_bounds().min, Vector3(6, 0, 0));
+    EXPECT_EQ(mesh.get_world_bounds().max, Vector3(11, 2, 3));
+
+    app_data.add_mesh(std::move(mesh));
+    app_data.add_mesh(Mesh({{0, -1, 0}, {1, 0, 0}, {0, 0, 1}}, {}, {}, {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}}));
+    const auto bounds = app_data.get_scene_bounds();
+    EXPECT_EQ(bounds.min, Vector3(0, -1, 0));
+    EXPECT_EQ(bounds.max, Vector3(11, 2, 3));
+}
+
+TEST(FaceListTest, StoresPolygonsContiguously) {
+    using di_renderer::core::FaceList;
+    using di_renderer::core::FaceVerticeData;
+
+    FaceList faces = {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}, {{3, 0, 0}, {4, 1, 0}, {5, 2, 0}, {6, 3, 0}}};
+    EXPECT_FALSE(faces.is_triangle_list());
+    const std::vector<FaceVerticeData> pentagon = {{7, -1, 1}, {8, -1, 1}, {9, -1, 1}, {10, -1, 1}, {11, -1, 1}};
+    faces.append(pentagon.begin(), pentagon.end());
+
+    ASSERT_EQ(faces.size(), 3u);
+    EXPECT_EQ(faces.corner_count(), 12u);
+    EXPECT_EQ(faces[1].size(), 4u);
+    EXPECT_EQ(faces[2][4].vi, 11);
+    EXPECT_EQ(faces[1][3].ti, 3);
+
+    faces[0][1].vi = 42;
+    EXPECT_EQ(faces.corners()[1].vi, 42);
+
+    int next_vi = 0;
+    for (const auto face : faces) {
+        for (const auto& corner : face) {
+            if (next_vi != 1) {
+                EXPECT_EQ(corner.vi, next_vi);
+            }
+            ++next_vi;
+        }
+    }
+    EXPECT_EQ(next_vi, 12);
+
+    FaceList merged = {{{0, 0, 0}, {1, 1, 1}, {2, 2, 2}}};
+    EXPECT_TRUE(merged.is_triangle_list());
+    merged.append(faces);
+    ASSERT_EQ(merged.size(), 4u);
+    EXPECT_EQ(merged[3].size(), 5u);
+    EXPECT_EQ(merged[3][0].vi, 7);
+    EXPECT_FALSE(merged.is_triangle_list());
+
+    merged.clear();
+    EXPECT_TRUE(merged.empty());
+    EXPECT_EQ(merged.corner_count(), 0u);
+}
+
+TEST(FaceListTest, EdgeIndicesAreUnique) {
+    using di_renderer::core::FaceList;
+
+    // two triangles sharing the 1-2 edge, plus a quad and a degenerate face
+    const FaceList faces = {{{0, 0, 0}, {1, 0, 0}, {2, 0, 0}},
+                            {{2, 0, 0}, {1, 0, 0}, {3, 0, 0}},
+                            {{4, 0, 0}, {5, 0, 0}, {6, 0, 0}, {7, 0, 0}},
+                            {{8, 0, 0}, {8, 0, 0}}};
+
+    const std::vector<std::uint32_t> expected = {0, 1, 0, 2, 1, 2, 1, 3, 2, 3, 4, 5, 4, 7, 5, 6, 6, 7};
+    EXPECT_EQ(faces.get_edge_indices(), expected);
+    EXPECT_TRUE(FaceList{}.get_edge_indices().empty());
+}
+
+TEST(IndexedMeshTest, WeldsCornersAndKeepsSeams) {
+    using di_renderer::core::IndexedMesh;
+    using di_renderer::math::UVCoord;
+    using di_renderer::math::Vector3;
+
+    // a quad split into two triangles: corners 0 and 2 are shared, the UV seam at vertex 2 splits it in two
+    Mesh mesh({Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(1.0f, 1.0f, 0.0f),
+               Vector3(0.0f, 1.0f, 0.0f)},
+              {UVCoord(0.0f, 0.0f), UVCoord(1.0f, 0.0f), UVCoord(1.0f, 1.0f), UVCoord(0.5f, 0.5f),
+               UVCoord(0.0f, 1.0f)},
+              {Vector3(0.0f, 0.0f, 1.0f)},
+              {{{0, 0, 0}, {1, 1, 0}, {2, 2, 0}},
+               {{0, 0, 0}, {2, 3, 0}, {3, 4, 0}},
+               {{0, 0, 0}, {9, 0, 0}, {1, 1, 0}}}); // out-of-range position, dropped
+
+    const IndexedMesh indexed(mesh);
+    ASSERT_EQ(indexed.vertices().size(), 5u);
+    ASSERT_TRUE(indexed.has_16bit_indices());
+    const std::vector<std::uint16_t> expected_indices = {0, 1, 2, 0, 3, 4};
+    EXPECT_EQ(indexed.indices16(), expected_indices);
+    EXPECT_EQ(indexed.index_count(), 6u);
+    EXPECT_FLOAT_EQ(indexed.vertices()[3].uv.u, 0.5f);
+    EXPECT_FLOAT_EQ(indexed.vertices()[3].position.y, 1.0f);
+    EXPECT_FLOAT_EQ(indexed.vertices()[4].normal.z, 1.0f);
+
+    // missing normals fall back to the per-position ones computed by Mesh
+    Mesh no_normals({Vector3(0.0f, 0.0f, 0.0f), Vector3(1.0f, 0.0f, 0.0f), Vector3(0.0f, 1.0f, 0.0f)}, {}, {},
+                    {{{0, -1, -1}, {1, -1, -1}, {2, -1, -1}}});
+    const IndexedMesh welded(no_normals);
+    ASSERT_EQ(welded.vertices().size(), 3u);
+    EXPECT_FLOAT_EQ(welded.vertices()[1].normal.z, 1.0f);
+    EXPECT_FLOAT_EQ(welded.vertices()[1].uv.u, 0.0f);
+
+    // edges of both triangles plus the diagonal, each once
+    EXPECT_EQ(indexed.get_edge_indices(mesh.faces).size(), 10u);
+}
+
+TEST(CoreTests, ChangeCallbackFiresOnSceneChanges) {
+    AppData app_data;
+    int changes = 0;
+    app_data.set_change_callback([&changes] { ++changes; });
+
+    app_data.add_mesh(Mesh());
+    app_data.add_mesh(Mesh());
+    EXPECT_EQ(changes, 2);
+
+    app_data.move_left();
+    EXPECT_EQ(changes, 3);
+
+    app_data.enable_render_mode(RenderMode::TEXTURE);
+    app_data.enable_render_mode(RenderMode::TEXTURE); // no actual change
+    EXPECT_EQ(changes, 4);
+
+    app_data.set_current_camera(3);
+    app_data.delete_current_camera();
+    EXPECT_EQ(changes, 6);
+
+    app_data.remove_current_mesh();
+    EXPECT_EQ(changes, 7);
+
+    app_data.get_current_camera().move({1.0f, 0.0f, 0.0f}); // edits through references are not tracked
+    EXPECT_EQ(changes, 7);
+}
+
+TEST(CoreTests, ChangeCallbackExceptionsDontEscapeSetters) {
+    AppData app_data;
+    int changes = 0;
+    app_data.set_change_callback([&changes] {
+        ++changes;
+        throw std::runtime_error("callback failed");
+    });
+
+    EXPECT_NO_THROW(app_data.add_mesh(Mesh()));
+    EXPECT_NO_THROW(app_data.set_render_mode(RenderMode::POLYGON, true));
+    EXPECT_NO_THROW(app_data.set_current_camera(1));
+    EXPECT_NO_THROW(app_data.clean());
+    EXPECT_EQ(changes, 4);
+}
@@ -0,0 +1,104 @@
+#include "headless/ImageWriter.hpp"
+#include "headless/Options.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using di_renderer::headless::Options;
+using di_renderer::headless::parse_options;
+
+namespace {
+    // argv as main receives it, with a program name in front of args
+    std::optional<Options> parse(std::vector<std::string> args) {
+        args.insert(args.begin(), "3d-renderer-headless");
+        std::vector<char*> argv;
+        for (auto& arg : args) {
+            argv.push_back(arg.data());
+        }
+        return parse_options(static_cast<int>(argv.size()), argv.data());
+    }
+
+    std::string read_file(const std::string& filename) {
+        std::ifstream file(filename, std::ios::binary);
+        return {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()};
+    }
+} // namespace
+
+TEST(ImageWriterTests, WritesHeaderAndRowsTopFirst) {
+    const auto* filename = "test_image_tmp.ppm";
+    // 2x2: top row red, green, bottom row blue, white
+    const std::vector<std::uint8_t> pixels = {255, 0, 0, 0, 255, 0, 0, 0, 255, 255, 255, 255};
+    di_renderer::headless::write_ppm(filename, 2, 2, pixels);
+
+    const std::string header = "P6\n2 2\n255\n";
+    const std::string content = read_file(filename);
+    ASSERT_EQ(content.size(), header.size() + pixels.size());
+    EXPECT_EQ(content.substr(0, header.size()), header);
+    EXPECT_EQ(content.substr(header.size()), std::string(pixels.begin(), pixels.end()));
+
+    std::remove(filename);
+}
+
+TEST(ImageWriterTests, RejectsPixelDataOfTheWrongSize) {
+    const auto* filename = "test_image_size_tmp.ppm";
+    EXPECT_THROW(di_renderer::headless::write_ppm(filename, 2, 2, std::vector<std::uint8_t>(11)), std::runtime_error);
+    EXPECT_THROW(di_renderer::headless::write_ppm(filename, 0, 2, {}), std::runtime_error);
+    std::remove(filename);
+}
+
+TEST(HeadlessOptionsTests, ParsesEveryOption) {
+    const auto options = parse({"--size", "640x480", "--frames", "3", "--camera", "1,2,3:0,0,-1.5", "--camera",
+                                "0,0,5:0,0,0", "--output", "out", "--no-images", "--software", "a.obj", "b.obj"});
+    ASSERT_TRUE(options.has_value());
+    EXPECT_EQ(options->width, 640);
+    EXPECT_EQ(options->height, 480);
+    EXPECT_EQ(options->frames, 3);
+    ASSERT_EQ(options->cameras.size(), 2u);
+    EXPECT_FLOAT_EQ(options->cameras[0].first.y, 2.0f);
+    EXPECT_FLOAT_EQ(options->cameras[0].second.z, -1.5f);
+    EXPECT_FLOAT_EQ(options->cameras[1].first.z, 5.0f);
+    EXPECT_EQ(options->output, "out");
+    EXPECT_FALSE(options->write_images);
+    EXPECT_TRUE(options->software);
+    EXPECT_EQ(options->models, (std::vector<std::string>{"a.obj", "b.obj"}));
+}
+
+TEST(HeadlessOptionsTests, DefaultsAndHelp) {
+    const auto options = parse({"model.obj"});
+    ASSERT_TRUE(options.has_value());
+    EXPECT_EQ(options->width, 512);
+    EXPECT_EQ(options->height, 512);
+    EXPECT_EQ(options->frames, 1);
+    EXPECT_TRUE(options->cameras.empty());
+    EXPECT_EQ(options->output, ".");
+    EXPECT_TRUE(options->write_images);
+    EXPECT_FALSE(options->software);
+
+    EXPECT_FALSE(parse({"--help"}).has_value());
+    EXPECT_FALSE(parse({"model.obj", "-h"}).has_value());
+}
+
+TEST(HeadlessOptionsTests, RejectsMalformedArguments) {
+    const std::vector<std::vector<std::string>> bad_arguments = {
+        {},
+        {"--size", "640", "a.obj"},
+        {"--size", "0x480", "a.obj"},
+        {"--size", "640x480px", "a.obj"},
+        {"--frames", "-1", "a.obj"},
+        {"a.obj", "--frames"},
+        {"--camera", "1,2,3", "a.obj"},
+        {"--camera", "1,2:0,0,0", "a.obj"},
+        {"--camera", "1,2,3,4:0,0,0", "a.obj"},
+        {"--bogus", "a.obj"},
+    };
+    for (const auto& args : bad_arguments) {
+        EXPECT_THROW(parse(args), std::invalid_argument) << (args.empty() ? "" : args.front());
+    }
+}
@@ -1,12 +1,17 @@
 #include "core/Mesh.hpp"
+#include "io/MeshCache.hpp"
 #include "io/ObjReader.hpp"
 #include "io/ObjWriter.hpp"
 
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
 #include <gtest/gtest.h>
 #include <sstream>
 #include <string>
+#include <thread>
 
 using di_renderer::io::ObjData;
 using di_renderer::io::ObjReader;
@@ -176,6 +181,94 @@ namespace di_renderer::io {
             EXPECT_TRUE(content.find("v -1 -2 -3") != std::string::npos);
         }
 
+        TEST_F(ObjWriterTest, BakesTransformWhenRequested) {
+            const std::string filename = get_test_file_path("baked.obj");
+
+            core::Mesh mesh;
+            mesh.vertices = {{1.0f, 2.0f, 3.0f}};
+            mesh.normals = {{1.0f, 0.0f, 0.0f}};
+            mesh.get_transform().set_position({10.0f, 0.0f, -1.0f});
+            mesh.get_transform().set_scale({2.0f, 2.0f, 2.0f});
+
+            ObjWriter::write_file(filename, mesh, true);
+            const std::string content = read_file_content(filename);
+            EXPECT_NE(content.find("v 12 4 5"), std::string::npos);
+            EXPECT_NE(content.find("vn 1 0 0"), std::string::npos);
+
+            ObjWriter::write_file(filename, mesh);
+            EXPECT_NE(read_file_content(filename).find("v 1 2 3"), std::string::npos);
+        }
+
+        TEST_F(ObjWriterTest, WritesShortestRoundTripFloats) {
+            const std::string filename = get_test_file_path("round_trip.obj");
+
+            core::Mesh mesh;
+            mesh.vertices = {{0.1f, 1.0f / 3.0f, 1e-7f}, {-123456.79f, 0.0f, 2.5f}};
+
+            ObjWriter::write_file(filename, mesh);
+            const std::string content = read_file_content(filename);
+            EXPECT_NE(content.find("v 0.1 0.33333334 1e-07\n"), std::string::npos);
+            EXPECT_NE(content.find("v -123456.79 0 2.5\n"), std::string::npos);
+
+            const ObjData data = ObjReader::read_file(filename);
+            ASSERT_EQ(data.vertices.size(), mesh.vertices.size());
+            for (std::size_t i = 0; i < mesh.vertices.size(); ++i) {
+                EXPECT_EQ(data.vertices[i].x, mesh.vertices[i].x);
+                EXPECT_EQ(data.vertices[i].y, mesh.vertices[i].y);
+                EXPECT_EQ(data.vertices[i].z, mesh.vertices[i].z);
+            }
+        }
+
+        TEST_F(ObjWriterTest, PrecisionLimitsSignificantDigits) {
+            const std::string filename = get_test_file_path("precision.obj");
+
+            core::Mesh mesh;
+            mesh.vertices = {{0.1f, 1.0f / 3.0f, 1e-7f}};
+            mesh.texture_vertices = {{0.123456f, 0.5f}};
+
+            ObjWriter::write_file(filename, mesh, false, {3, false});
+            const std::string content = read_file_content(filename);
+            EXPECT_NE(content.find("v 0.1 0.333 1e-07\n"), std::string::npos);
+            EXPECT_NE(content.find("vt 0.123 0.5\n"), std::string::npos);
+        }
+
+        TEST_F(ObjWriterTest, ParallelSectionsWriteTheSameFile) {
+            const std::string serial = get_test_file_path("serial.obj");
+            const std::string parallel = get_test_file_path("parallel.obj");
+
+            // large enough for the serial writer to flush several times
+            core::Mesh mesh;
+            constexpr int COUNT = 50000;
+            for (int i = 0; i < COUNT; ++i) {
+                const float t = static_cast<float>(i) / COUNT;
+                mesh.vertices.emplace_back(t * 3.7f, -t, t * t);
+                mesh.texture_vertices.emplace_back(t, 1.0f - t);
+                mesh.normals.emplace_back(0.0f, t, 1.0f);
+            }
+            for (int i = 0; i + 2 < COUNT; ++i) {
+                mesh.faces.push_back({{i, i, i}, {i + 1, -1, i + 1}, {i + 2, i + 2, -1}});
+            }
+
+            ObjWriter::write_file(serial, mesh);
+            ObjWriter::write_file(parallel, mesh, false, {0, true});
+            EXPECT_GT(fs::file_size(serial), ObjWriter::FLUSH_SIZE * 2);
+            EXPECT_EQ(read_file_content(serial), read_file_content(parallel));
+
+            const ObjData data = ObjReader::read_file(parallel);
+            ASSERT_EQ(data.vertices.size(), mesh.vertices.size());
+            ASSERT_EQ(data.faces.size(), mesh.faces.size());
+            EXPECT_EQ(data.vertices.back().x, mesh.vertices.back().x);
+            EXPECT_EQ(data.texture_vertices[777].u, mesh.texture_vertices[777].u);
+            const auto& read_corners = data.faces.corners();
+            const auto& written_corners = mesh.faces.corners();
+            ASSERT_EQ(read_corners.size(), written_corners.size());
+            for (std::size_t i = 0; i < read_corners.size(); ++i) {
+                EXPECT_EQ(read_corners[i].vi, written_corners[i].vi);
+                EXPECT_EQ(read_corners[i].ti, written_corners[i].ti);
+                EXPECT_EQ(read_corners[i].ni, written_corners[i].ni);
+            }
+        }
+
         // Test writing texture coordinates
         TEST_F(ObjWriterTest, WritesTextureVerticesCorrectly) {
             const std::string filename = get_test_file_path("texcoords.obj");
@@ -526,3 +619,306 @@ TEST(ObjReaderTests, BasicObjParsing) {
     EXPECT_EQ(faces[0][1].ti, 0);
     EXPECT_EQ(faces[0][1].ni, 0);
 }
+
+namespace {
+    void write_text_file(const std::string& filename, const std::string& content) {
+        std::ofstream out(filename, std::ios::binary);
+        out << content;
+    }
+
+    void expect_same_obj_data(const ObjData& lhs, const ObjData& rhs) {
+        ASSERT_EQ(lhs.vertices.size(), rhs.vertices.size());
+        for (size_t i = 0; i < lhs.vertices.size(); ++i) {
+            EXPECT_EQ(lhs.vertices[i], rhs.vertices[i]);
+        }
+        ASSERT_EQ(lhs.texture_vertices.size(), rhs.texture_vertices.size());
+        for (size_t i = 0; i < lhs.texture_vertices.size(); ++i) {
+            EXPECT_FLOAT_EQ(lhs.texture_vertices[i].u, rhs.texture_vertices[i].u);
+            EXPECT_FLOAT_EQ(lhs.texture_vertices[i].v, rhs.texture_vertices[i].v);
+        }
+        ASSERT_EQ(lhs.normals.size(), rhs.normals.size());
+        for (size_t i = 0; i < lhs.normals.size(); ++i) {
+            EXPECT_EQ(lhs.normals[i], rhs.normals[i]);
+        }
+        ASSERT_EQ(lhs.faces.size(), rhs.faces.size());
+        for (size_t i = 0; i < lhs.faces.size(); ++i) {
+            ASSERT_EQ(lhs.faces[i].size(), rhs.faces[i].size());
+            for (size_t j = 0; j < lhs.faces[i].size(); ++j) {
+                EXPECT_EQ(lhs.faces[i][j].vi, rhs.faces[i][j].vi);
+                EXPECT_EQ(lhs.faces[i][j].ti, rhs.faces[i][j].ti);
+                EXPECT_EQ(lhs.faces[i][j].ni, rhs.faces[i][j].ni);
+            }
+        }
+    }
+} // namespace
+
+TEST(ObjReaderTests, MappedModeMatchesStreamMode) {
+    const auto* filename = "test_modes_tmp.obj";
+    write_text_file(filename, "# comment\r\n"
+                              "o cube\r\n"
+                              "v 1.5 -2.25 3e2\r\n"
+                              "v +4.0 5 6\n"
+                              "v\t7 8 9   \n"
+                              "v -0.125 .5 1.\n"
+                              "\r\n"
+                              "vt 0.1 0.2\n"
+                              "vt 1 0\n"
+                              "vn 0.0 1.0 0.0\n"
+                              "s off\n"
+                              "f 1/1/1 2/2/1 3/1/1\n"
+                              "f 1//1 2//1 3//1 4//1\r\n"
+                              "f 1/2 2/1 4/\n"
+                              "f 4 3 2");
+
+    const ObjData stream_data = ObjReader::read_file(filename, di_renderer::io::ObjReadMode::STREAM);
+    const ObjData mapped_data = ObjReader::read_file(filename, di_renderer::io::ObjReadMode::MAPPED);
+
+    ASSERT_EQ(mapped_data.vertices.size(), 4);
+    EXPECT_FLOAT_EQ(mapped_data.vertices[0].z, 300.0f);
+    ASSERT_EQ(mapped_data.faces.size(), 4);
+    EXPECT_EQ(mapped_data.faces[1][3].vi, 3);
+    EXPECT_EQ(mapped_data.faces[1][3].ti, -1);
+    EXPECT_EQ(mapped_data.faces[1][3].ni, 0);
+    expect_same_obj_data(stream_data, mapped_data);
+
+    std::remove(filename);
+}
+
+TEST(ObjReaderTests, MappedModeKeepsErrorSemantics) {
+    const auto* filename = "test_errors_tmp.obj";
+
+    write_text_file(filename, "v 1 2 3\nf 1/a/1 1 1\n");
+    EXPECT_THROW(ObjReader::read_file(filename), std::runtime_error);
+
+    write_text_file(filename, "v 1 2 3\nf -1 1 1\n");
+    EXPECT_THROW(ObjReader::read_file(filename), std::runtime_error);
+
+    write_text_file(filename, "v 1 2 3\nf 1/1/1/1 1 1\n");
+    EXPECT_THROW(ObjReader::read_file(filename), std::runtime_error);
+
+    write_text_file(filename, "v 1 2 3\nbogus 1 2\n");
+    EXPECT_THROW(ObjReader::read_file(filename), std::runtime_error);
+
+    write_text_file(filename, "");
+    EXPECT_TRUE(ObjReader::read_file(filename).vertices.empty());
+
+    std::remove(filename);
+
+    EXPECT_THROW(ObjReader::read_file("definitely_missing_file.obj"), std::runtime_error);
+}
+
+TEST(ObjReaderTests, ShortVertexLinesAreRejectedInEveryMode) {
+    using di_renderer::io::ObjReadMode;
+    const auto* filename = "test_short_lines_tmp.obj";
+
+    for (const auto mode : {ObjReadMode::STREAM, ObjReadMode::MAPPED, ObjReadMode::PARALLEL}) {
+        for (const auto* content : {"v 1 2 3\nv 4 5\n", "v 1 2 3\nv 4 5 x\n", "vn 0 1\n", "vt\n", "vt 0.5 x\n"}) {
+            write_text_file(filename, content);
+            EXPECT_THROW(ObjReader::read_file(filename, mode), std::runtime_error) << content;
+        }
+
+        // the v of a texture vertex is optional
+        write_text_file(filename, "vt 0.25\r\nvt 0.5 0.75\n");
+        const ObjData data = ObjReader::read_file(filename, mode);
+        ASSERT_EQ(data.texture_vertices.size(), 2u);
+        EXPECT_FLOAT_EQ(data.texture_vertices[0].u, 0.25f);
+        EXPECT_FLOAT_EQ(data.texture_vertices[0].v, 0.0f);
+        EXPECT_FLOAT_EQ(data.texture_vertices[1].v, 0.75f);
+    }
+
+    std::remove(filename);
+}
+
+TEST(ObjReaderTests, ParallelParseMatchesSerialParse) {
+    std::ostringstream text;
+    text << "# generated\n";
+    for (int i = 0; i < 300; ++i) {
+        text << "v " << i << " " << i * 0.5f << " " << -i << "\n";
+        text << "vt " << i * 0.001f << " 0.5\r\n";
+        if (i == 150) {
+            text << "g second_half\n";
+        }
+    }
+    text << "vn 0 0 1\n";
+    for (int i = 1; i + 2 <= 300; ++i) {
+        text << "f " << i << "/" << i << "/1 " << i + 1 << "//1 " << i + 2 << "\n";
+    }
+    const std::string content = text.str();
+
+    const ObjData serial = ObjReader::parse(content);
+    for (const std::size_t chunk_count : {1, 2, 3, 7, 64}) {
+        expect_same_obj_data(serial, ObjReader::parse_parallel(content, chunk_count));
+    }
+
+    const auto* filename = "test_parallel_tmp.obj";
+    write_text_file(filename, content);
+    expect_same_obj_data(serial, ObjReader::read_file(filename, di_renderer::io::ObjReadMode::PARALLEL));
+    std::remove(filename);
+}
+
+TEST(ObjReaderTests, ParallelParseReportsFirstErrorInFileOrder) {
+    std::string content;
+    for (int i = 0; i < 200; ++i) {
+        content += "v 1 2 3\n";
+    }
+    content += "f 1/x 1 1\n";
+    for (int i = 0; i < 200; ++i) {
+        content += "v 1 2 3\n";
+    }
+    content += "bogus\n";
+
+    try {
+        ObjReader::parse_parallel(content, 4);
+        FAIL() << "Expected parse error";
+    } catch (const std::runtime_error& e) {
+        EXPECT_STREQ(e.what(), "Bad face pattern");
+    }
+}
+
+TEST(MeshCacheTests, RoundTripsAndInvalidatesOnChange) {
+    using di_renderer::io::MeshCache;
+
+    const fs::path cache_home = fs::absolute("test_cache_home");
+    fs::remove_all(cache_home);
+    setenv("XDG_CACHE_HOME", cache_home.c_str(), 1); // NOLINT(*-mt-unsafe)
+
+    const auto* filename = "test_cache_tmp.obj";
+    write_text_file(filename, "v 0 0 0\nv 1 0 0\nv 1 1 0\nv 0 1 0\nvt 0 0\nvt 1 1\nf 1/1 2/2 3/1 4/2\n");
+
+    EXPECT_FALSE(MeshCache::load(filename).has_value());
+    const di_renderer::core::Mesh read_mesh = MeshCache::load_or_read(filename);
+    ASSERT_TRUE(fs::exists(MeshCache::get_cache_path(filename)));
+
+    const auto cached = MeshCache::load(filename);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->face_count(), 2u);
+    ASSERT_EQ(cached->vertices.size(), read_mesh.vertices.size());
+    ASSERT_EQ(cached->normals.size(), read_mesh.normals.size());
+    for (size_t i = 0; i < read_mesh.vertices.size(); ++i) {
+        EXPECT_EQ(cached->vertices[i], read_mesh.vertices[i]);
+        EXPECT_EQ(cached->normals[i], read_mesh.normals[i]);
+    }
+    ASSERT_EQ(cached->texture_vertices.size(), 2u);
+    EXPECT_FLOAT_EQ(cached->texture_vertices[1].v, 1.0f);
+    for (size_t i = 0; i < read_mesh.faces.corner_count(); ++i) {
+        EXPECT_EQ(cached->faces.corners()[i].vi, read_mesh.faces.corners()[i].vi);
+        EXPECT_EQ(cached->faces.corners()[i].ti, read_mesh.faces.corners()[i].ti);
+        EXPECT_EQ(cached->faces.corners()[i].ni, read_mesh.faces.corners()[i].ni);
+    }
+
+    // a different size invalidates the entry
+    write_text_file(filename, "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n");
+    EXPECT_FALSE(MeshCache::load(filename).has_value());
+    EXPECT_EQ(MeshCache::load_or_read(filename).vertex_count(), 3u);
+
+    // so does a truncated cache file
+    const fs::path cache_path = MeshCache::get_cache_path(filename);
+    fs::resize_file(cache_path, fs::file_size(cache_path) - 1);
+    EXPECT_FALSE(MeshCache::load(filename).has_value());
+
+    std::remove(filename);
+    fs::remove_all(cache_home);
+    unsetenv("XDG_CACHE_HOME"); // NOLINT(*-mt-unsafe)
+}
+
+TEST(MeshCacheTests, ConcurrentStoresPublishACompleteEntry) {
+    using di_renderer::io::MeshCache;
+
+    const fs::path cache_home = fs::absolute("test_cache_concurrent_home");
+    fs::remove_all(cache_home);
+    setenv("XDG_CACHE_HOME", cache_home.c_str(), 1); // NOLINT(*-mt-unsafe)
+
+    const auto* filename = "test_cache_concurrent_tmp.obj";
+    std::string content;
+    for (int i = 0; i < 3000; ++i) {
+        content += "v " + std::to_string(i) + " 0 0\n";
+    }
+    for (int i = 1; i + 2 <= 3000; ++i) {
+        content += "f " + std::to_string(i) + " " + std::to_string(i + 1) + " " + std::to_string(i + 2) + "\n";
+    }
+    write_text_file(filename, content);
+    const di_renderer::core::Mesh mesh = MeshCache::load_or_read(filename);
+
+    std::vector<std::thread> writers;
+    for (int i = 0; i < 4; ++i) {
+        writers.emplace_back([&] {
+            for (int k = 0; k < 10; ++k) {
+                MeshCache::store(filename, mesh);
+            }
+        });
+    }
+    for (auto& writer : writers) {
+        writer.join();
+    }
+
+    const auto cached = MeshCache::load(filename);
+    ASSERT_TRUE(cached.has_value());
+    EXPECT_EQ(cached->vertex_count(), mesh.vertex_count());
+    EXPECT_EQ(cached->face_count(), mesh.face_count());
+    // every writer renamed its own temporary file
+    for (const auto& entry : fs::directory_iterator(MeshCache::get_cache_path(filename).parent_path())) {
+        EXPECT_NE(entry.path().extension(), ".tmp");
+    }
+
+    std::remove(filename);
+    fs::remove_all(cache_home);
+    unsetenv("XDG_CACHE_HOME"); // NOLINT(*-mt-unsafe)
+}
+
+TEST(MeshCacheTests, ProgressCancelsBetweenPhases) {
+    using di_renderer::io::MeshCache;
+
+    const fs::path cache_home = fs::absolute("test_cache_cancel_home");
+    fs::remove_all(cache_home);
+    setenv("XDG_CACHE_HOME", cache_home.c_str(), 1); // NOLINT(*-mt-unsafe)
+
+    const auto* filename = "test_cache_cancel_tmp.obj";
+    write_text_file(filename, "v 0 0 0\nv 1 0 0\nv 1 1 0\nf 1 2 3\n");
+
+    std::vector<float> reports;
+    MeshCache::load_or_read(filename, [&reports](const float progress) { reports.push_back(progress); });
+    ASSERT_GE(reports.size(), 3u);
+    for (size_t i = 1; i < reports.size(); ++i) {
+        EXPECT_GE(reports[i], reports[i - 1]);
+    }
+    EXPECT_FLOAT_EQ(reports.back(), 1.0f);
+
+    // throwing once the mesh is read stops the load before anything is written to the cache
+    fs::remove_all(cache_home);
+    const auto cancel_after_read = [](const float progress) {
+        if (progress >= 0.8f) {
+            throw std::runtime_error("cancelled");
+        }
+    };
+    EXPECT_THROW(MeshCache::load_or_read(filename, cancel_after_read), std::runtime_error);
+    EXPECT_FALSE(fs::exists(MeshCache::get_cache_path(filename)));
+
+    std::remove(filename);
+    fs::remove_all(cache_home);
+    unsetenv("XDG_CACHE_HOME"); // NOLINT(*-mt-unsafe)
+}
+
+TEST(ObjReaderTests, ReportsProgressAndStopsWhenCallbackThrows) {
+    const std::string content(3U << 20U, '#');
+    std::string text;
+    for (size_t i = 0; i < content.size(); i += 64) {
+        text.append(content, i, 63).push_back('\n');
+    }
+
+    std::vector<float> reports;
+    ObjReader::parse(text, [&reports](const float progress) { reports.push_back(progress); });
+    ASSERT_GE(reports.size(), 3u);
+    for (size_t i = 1; i < reports.size(); ++i) {
+        EXPECT_GE(reports[i], reports[i - 1]);
+    }
+    EXPECT_FLOAT_EQ(reports.back(), 1.0f);
+
+    std::atomic<int> calls{0};
+    const auto cancel = [&calls](float) {
+        ++calls;
+        throw std::runtime_error("cancelled");
+    };
+    EXPECT_THROW(ObjReader::parse(text, cancel), std::runtime_error);
+    EXPECT_EQ(calls.load(), 1);
+    EXPECT_THROW(ObjReader::parse_parallel(text, 3, cancel), std::runtime_error);
+}
@@ -0,0 +1,132 @@
+#include "jobs/JobSystem.hpp"
+#include "jobs/TaskGraph.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace di_renderer::jobs;
+
+TEST(JobSystemTests, ChunkBoundsCoverEveryItemOnce) {
+    const JobSystem system(4);
+    EXPECT_EQ(system.get_thread_count(), 4u);
+    EXPECT_EQ(system.get_chunk_count(0, 1), 0u);
+    EXPECT_EQ(system.get_chunk_count(10, 100), 1u);
+    EXPECT_EQ(system.get_chunk_count(1000, 1), 16u);
+    EXPECT_EQ(system.get_chunk_count(1000, 1, 3), 3u);
+    EXPECT_EQ(JobSystem(1).get_chunk_count(1000, 1), 1u);
+
+    std::size_t next = 0;
+    for (std::size_t i = 0; i < 3; ++i) {
+        const auto [begin, end] = JobSystem::get_chunk_bounds(10, 3, i);
+        EXPECT_EQ(begin, next);
+        EXPECT_GE(end - begin, 3u);
+        next = end;
+    }
+    EXPECT_EQ(next, 10u);
+}
+
+TEST(JobSystemTests, ParallelForVisitsEveryIndex) {
+    JobSystem system(4);
+    std::vector<int> visits(100000, 0);
+    system.parallel_for(visits.size(), 1000, [&](const std::size_t begin, const std::size_t end) {
+        for (std::size_t i = begin; i < end; ++i) {
+            ++visits[i];
+        }
+    });
+    EXPECT_EQ(std::count(visits.begin(), visits.end(), 1), static_cast<std::ptrdiff_t>(visits.size()));
+
+    const auto sums = system.parallel_map(visits.size(), 1000, [&](const std::size_t begin, const std::size_t end) {
+        return std::accumulate(visits.begin() + static_cast<std::ptrdiff_t>(begin),
+                               visits.begin() + static_cast<std::ptrdiff_t>(end), std::size_t{0});
+    });
+    EXPECT_EQ(std::accumulate(sums.begin(), sums.end(), std::size_t{0}), visits.size());
+}
+
+TEST(JobSystemTests, NestedLoopsDoNotDeadlock) {
+    JobSystem system(2);
+    std::atomic<int> total{0};
+    system.parallel_for_each(8, [&](std::size_t) {
+        system.parallel_for_each(8, [&](std::size_t) { total.fetch_add(1); });
+    });
+    EXPECT_EQ(total.load(), 64);
+}
+
+TEST(JobSystemTests, SingleThreadRunsInSubmissionOrder) {
+    JobSystem system(1);
+    std::vector<std::size_t> order;
+    TaskGroup group(system);
+    for (std::size_t i = 0; i < 5; ++i) {
+        group.run([&order, i] { order.push_back(i); });
+    }
+    EXPECT_TRUE(order.empty());
+    group.wait();
+    EXPECT_EQ(order, (std::vector<std::size_t>{0, 1, 2, 3, 4}));
+
+    order.clear();
+    system.parallel_for_each(4, [&](const std::size_t i) { order.push_back(i); });
+    EXPECT_EQ(order, (std::vector<std::size_t>{0, 1, 2, 3}));
+}
+
+TEST(JobSystemTests, ErrorsReachTheWaitingThread) {
+    for (const std::size_t thread_count : {1, 4}) {
+        JobSystem system(thread_count);
+        std::atomic<int> finished{0};
+        EXPECT_THROW(system.parallel_for_each(16,
+                                              [&](const std::size_t i) {
+                                                  if (i == 5) {
+                                                      throw std::runtime_error("failed");
+                                                  }
+                                                  finished.fetch_add(1);
+                                              }),
+                     std::runtime_error);
+        EXPECT_EQ(finished.load(), 15);
+    }
+}
+
+TEST(TaskGraphTests, RunsTasksAfterTheirDependencies) {
+    JobSystem system(4);
+    std::mutex mutex;
+    std::vector<char> order;
+    const auto record = [&](const char name) {
+        return [&, name] {
+            const std::lock_guard lock(mutex);
+            order.push_back(name);
+        };
+    };
+
+    TaskGraph graph;
+    const auto a = graph.add(record('a'));
+    const auto b = graph.add(record('b'), {a});
+    const auto c = graph.add(record('c'), {a});
+    graph.add(record('d'), {b, c});
+    EXPECT_THROW(graph.add(record('e'), {4}), std::runtime_error);
+
+    for (int run = 0; run < 2; ++run) {
+        order.clear();
+        graph.run(system);
+        ASSERT_EQ(order.size(), 4u);
+        EXPECT_EQ(order.front(), 'a');
+        EXPECT_EQ(order.back(), 'd');
+    }
+
+    order.clear();
+    JobSystem single_thread(1);
+    graph.run(single_thread);
+    EXPECT_EQ(order, (std::vector<char>{'a', 'b', 'c', 'd'}));
+}
+
+TEST(TaskGraphTests, SkipsDependentsOfFailedTasks) {
+    JobSystem system(1);
+    std::vector<int> ran;
+    TaskGraph graph;
+    const auto failing = graph.add([] { throw std::runtime_error("failed"); });
+    graph.add([&] { ran.push_back(1); }, {failing});
+    graph.add([&] { ran.push_back(2); });
+    EXPECT_THROW(graph.run(system), std::runtime_error);
+    EXPECT_EQ(ran, std::vector<int>{2});
+}
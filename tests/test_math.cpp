@@ -1,4 +1,7 @@
+#include "math/BatchTransforms.hpp"
+#include "math/BoundingBox.hpp"
 #include "math/Camera.hpp"
+#include "math/Frustum.hpp"
 #include "math/Matrix4x4.hpp"
 #include "math/MatrixTransforms.hpp"
 #include "math/Transform.hpp"
@@ -7,6 +10,8 @@
 #include "math/Vector4.hpp"
 
 #include <cmath>
+#include <limits>
+#include <vector>
 #include <gtest/gtest.h>
 
 using namespace di_renderer::math;
@@ -179,6 +184,41 @@ TEST(Matrix4x4Tests, Inverse) {
     EXPECT_EQ(res, Matrix4x4::identity());
 }
 
+TEST(Matrix4x4Tests, ConstexprConstruction) {
+    constexpr Matrix4x4 model = MatrixTransforms::translate(Vector3(1, 2, 3));
+    static_assert(model(0, 3) == 1.0f && model(1, 3) == 2.0f && model(2, 3) == 3.0f && model(3, 3) == 1.0f);
+    static_assert(Matrix4x4::identity()(2, 2) == 1.0f && Matrix4x4::identity()(2, 1) == 0.0f);
+
+    constexpr Matrix4x4 scale = MatrixTransforms::scale(Vector3(2, 3, 4));
+    static_assert(scale(1, 1) == 3.0f && scale(0, 3) == 0.0f);
+
+    constexpr Matrix4x4 counting([](int row, int col) { return static_cast<float>((row * 4) + col); });
+    static_assert(counting(2, 1) == 9.0f);
+    static_assert(noexcept(counting(0, 0)) && noexcept(counting * counting));
+
+    EXPECT_EQ(model * scale, MatrixTransforms::translate(Vector3(1, 2, 3)) * MatrixTransforms::scale(Vector3(2, 3, 4)));
+}
+
+TEST(Matrix4x4Tests, GeneralInverseAndTranspose) {
+    // no zero entries, so every cofactor term takes part
+    const Matrix4x4 m(std::array<float, 16>{4.0f, 3.0f, 2.0f, 1.0f, 1.0f, 5.0f, 2.0f, 3.0f, 2.0f, 1.0f, 6.0f, 2.0f,
+                                            3.0f, 2.0f, 1.0f, 7.0f});
+    EXPECT_NEAR(m.determinant(), 577.0f, 1e-3f);
+
+    const Matrix4x4 product = m * m.inverse();
+    const Matrix4x4 id = Matrix4x4::identity();
+    for (size_t row = 0; row < 4; ++row) {
+        for (size_t col = 0; col < 4; ++col) {
+            EXPECT_NEAR(product(row, col), id(row, col), 1e-5f);
+        }
+    }
+
+    const Matrix4x4 t = m.transposed();
+    EXPECT_FLOAT_EQ(t(0, 1), m(1, 0));
+    EXPECT_FLOAT_EQ(t(3, 2), m(2, 3));
+    EXPECT_EQ(t.transposed(), m);
+}
+
 TEST(Matrix4x4Tests, ChainMultiplication) {
     Matrix4x4 t = Matrix4x4::identity(); // Translate (1, 2, 3)
     t(0, 3) = 1.0f;
@@ -402,3 +442,196 @@ TEST(CameraTests, Setters_UpdateMatrices) {
 
     EXPECT_EQ(cam.get_view_matrix(), expected);
 }
+
+TEST(CameraTests, VersionTracksChanges) {
+    Camera cam({0, 0, 5}, {0, 0, 0}, 1.0f, 1.0f, 0.1f, 100.0f);
+    const Camera other;
+    EXPECT_NE(cam.get_version(), other.get_version());
+
+    const auto version = cam.get_version();
+    const Matrix4x4 view = cam.get_view_matrix();
+    cam.set_aspect_ratio(1.0f);
+    cam.set_planes(0.1f, 100.0f);
+    EXPECT_EQ(cam.get_version(), version);
+
+    cam.set_aspect_ratio(2.0f);
+    EXPECT_GT(cam.get_version(), version);
+    EXPECT_EQ(cam.get_view_matrix(), view);
+    EXPECT_EQ(cam.get_projection_matrix(), MatrixTransforms::perspective(1.0f, 2.0f, 0.1f, 100.0f));
+
+    const auto projection_version = cam.get_version();
+    cam.orbit_around_target(10.0f, 0.0f);
+    EXPECT_GT(cam.get_version(), projection_version);
+    EXPECT_EQ(cam.get_view_matrix(), MatrixTransforms::look_at(cam.get_position(), cam.get_target(), {0, 1, 0}));
+    EXPECT_EQ(cam.get_view_projection_matrix(), cam.get_projection_matrix() * cam.get_view_matrix());
+}
+
+TEST(TransformTests, ClosedFormMatchesComposedMatrices) {
+    Transform t;
+    t.set_position(Vector3(5, -3, 1));
+    t.set_rotation(Vector3(0.3f, -1.2f, 2.7f));
+    t.set_scale(Vector3(2, 0.5f, 3));
+
+    const Vector3& r = t.get_rotation();
+    const Matrix4x4 composed = MatrixTransforms::translate(t.get_position()) * MatrixTransforms::rotate_z(r.z) *
+                               MatrixTransforms::rotate_y(r.y) * MatrixTransforms::rotate_x(r.x) *
+                               MatrixTransforms::scale(t.get_scale());
+    const Matrix4x4 composed_inverse = composed.inverse();
+    for (size_t row = 0; row < 4; ++row) {
+        for (size_t col = 0; col < 4; ++col) {
+            EXPECT_NEAR(t.get_matrix()(row, col), composed(row, col), 1e-5f);
+            EXPECT_NEAR(t.get_inverse_matrix()(row, col), composed_inverse(row, col), 1e-5f);
+            EXPECT_NEAR(t.get_normal_matrix()(row, col), composed_inverse(col, row), 1e-5f);
+        }
+    }
+
+    // setters invalidate the cache
+    t.translate(Vector3(1, 1, 1));
+    EXPECT_FLOAT_EQ(t.get_matrix()(0, 3), 6.0f);
+    t.set_scale(Vector3(0, 1, 1));
+    EXPECT_EQ(t.get_inverse_matrix(), Matrix4x4::identity());
+}
+
+TEST(TransformTests, NormalMatrix) {
+    Transform t;
+    t.set_scale(Vector3(2, 2, 2));
+    t.set_position(Vector3(5, -3, 1));
+
+    const Matrix4x4 n = t.get_normal_matrix();
+    EXPECT_NEAR(n(0, 0), 0.5f, 1e-6f);
+    EXPECT_NEAR(n(1, 1), 0.5f, 1e-6f);
+    EXPECT_NEAR(n(2, 2), 0.5f, 1e-6f);
+    EXPECT_NEAR(n(0, 1), 0.0f, 1e-6f);
+
+    // for a pure rotation the normal matrix is the rotation itself
+    Transform r;
+    r.set_rotation(Vector3(0, 0, M_PI / 2.0f));
+    const Vector4 normal = r.get_normal_matrix() * Vector4(1, 0, 0, 0);
+    EXPECT_NEAR(normal.x, 0.0f, 1e-6f);
+    EXPECT_NEAR(normal.y, 1.0f, 1e-6f);
+    EXPECT_NEAR(normal.z, 0.0f, 1e-6f);
+}
+
+TEST(BatchTransformsTests, MatchesSingleVectorTransform) {
+    Transform t;
+    t.set_position(Vector3(5, -3, 1));
+    t.set_rotation(Vector3(0.3f, -1.2f, 0.7f));
+    t.set_scale(Vector3(2, 0.5f, 3));
+    const Matrix4x4 m = t.get_matrix();
+
+    // enough points for several parallel chunks
+    std::vector<Vector3> points;
+    for (size_t i = 0; i < BatchTransforms::MIN_PARALLEL_CHUNK_SIZE * 3 + 7; ++i) {
+        const auto f = static_cast<float>(i);
+        points.emplace_back(std::sin(f) * 10.0f, std::cos(f * 0.5f) * 4.0f, f * 1e-4f);
+    }
+
+    std::vector<Vector3> out(points.size());
+    BatchTransforms::transform_points(m, points.data(), out.data(), points.size(), 4);
+    Vector3 min(1e30f, 1e30f, 1e30f);
+    Vector3 max(-1e30f, -1e30f, -1e30f);
+    for (size_t i = 0; i < points.size(); ++i) {
+        const Vector4 expected = m * Vector4(points[i].x, points[i].y, points[i].z, 1.0f);
+        ASSERT_FLOAT_EQ(out[i].x, expected.x);
+        ASSERT_FLOAT_EQ(out[i].y, expected.y);
+        ASSERT_FLOAT_EQ(out[i].z, expected.z);
+        min = Vector3(std::min(min.x, expected.x), std::min(min.y, expected.y), std::min(min.z, expected.z));
+        max = Vector3(std::max(max.x, expected.x), std::max(max.y, expected.y), std::max(max.z, expected.z));
+    }
+
+    const auto [bounds_min, bounds_max] = BatchTransforms::transformed_bounds(m, points.data(), points.size(), 0);
+    EXPECT_EQ(bounds_min, min);
+    EXPECT_EQ(bounds_max, max);
+
+    // in place, and normals come out unit length
+    std::vector<Vector3> normals = {Vector3(1, 0, 0), Vector3(0, 0, 0), Vector3(0, 1, 1)};
+    BatchTransforms::transform_normals(t.get_normal_matrix(), normals.data(), normals.data(), normals.size());
+    EXPECT_NEAR(normals[0].length(), 1.0f, 1e-6f);
+    EXPECT_EQ(normals[1], Vector3(0, 0, 0));
+    EXPECT_NEAR(normals[2].length(), 1.0f, 1e-6f);
+}
+
+TEST(BoundingBoxTests, TransformedMatchesCorners) {
+    EXPECT_TRUE(BoundingBox().is_empty());
+    EXPECT_TRUE(BoundingBox().transformed(Matrix4x4::identity()).is_empty());
+
+    const std::vector<Vector3> points = {{-1, 2, 0.5f}, {3, -4, 1}, {0, 0, -2}};
+    const BoundingBox box = BoundingBox::from_points(points.data(), points.size());
+    EXPECT_EQ(box.min, Vector3(-1, -4, -2));
+    EXPECT_EQ(box.max, Vector3(3, 2, 1));
+
+    const float inf = std::numeric_limits<float>::infinity();
+    const std::vector<Vector3> unbounded = {{-inf, 0, 1}, {2, inf, -1}};
+    const BoundingBox open = BoundingBox::from_points(unbounded.data(), unbounded.size());
+    // Vector3's == subtracts, which is NaN for infinities
+    EXPECT_EQ(open.min.x, -inf);
+    EXPECT_EQ(open.min.z, -1.0f);
+    EXPECT_EQ(open.max.y, inf);
+    EXPECT_EQ(open.max.x, 2.0f);
+
+    Transform t;
+    t.set_position(Vector3(5, -3, 1));
+    t.set_rotation(Vector3(0.3f, -1.2f, 0.7f));
+    t.set_scale(Vector3(2, 0.5f, 3));
+    const Matrix4x4& m = t.get_matrix();
+
+    BoundingBox corners;
+    for (int i = 0; i < 8; ++i) {
+        const Vector4 corner = m * Vector4((i & 1) != 0 ? box.max.x : box.min.x, (i & 2) != 0 ? box.max.y : box.min.y,
+                                           (i & 4) != 0 ? box.max.z : box.min.z, 1.0f);
+        corners.expand(Vector3(corner.x, corner.y, corner.z));
+    }
+    const BoundingBox moved = box.transformed(m);
+    EXPECT_NEAR(moved.min.x, corners.min.x, 1e-4f);
+    EXPECT_NEAR(moved.min.y, corners.min.y, 1e-4f);
+    EXPECT_NEAR(moved.min.z, corners.min.z, 1e-4f);
+    EXPECT_NEAR(moved.max.x, corners.max.x, 1e-4f);
+    EXPECT_NEAR(moved.max.y, corners.max.y, 1e-4f);
+    EXPECT_NEAR(moved.max.z, corners.max.z, 1e-4f);
+}
+
+TEST(FrustumTests, CullsBoxesOutsideTheView) {
+    // 90 degree field of view looking down -Z from z = 10, near 1, far 100
+    const Camera camera(Vector3(0, 0, 10), Vector3(0, 0, 0), static_cast<float>(M_PI) / 2.0f, 1.0f, 1.0f, 100.0f);
+    const Frustum frustum(camera.get_view_projection_matrix());
+    for (const auto& plane : frustum.get_planes()) {
+        EXPECT_NEAR(plane.normal.length(), 1.0f, 1e-5f);
+    }
+
+    const auto box = [](const Vector3& center, const float half) {
+        return BoundingBox(center - Vector3(half, half, half), center + Vector3(half, half, half));
+    };
+    EXPECT_TRUE(frustum.intersects(box({0, 0, 0}, 1)));
+    EXPECT_TRUE(frustum.intersects(box({0, 0, 9.5f}, 1)));  // straddles the near plane
+    EXPECT_TRUE(frustum.intersects(box({10.5f, 0, 0}, 1))); // straddles the right plane at x = 10
+    EXPECT_FALSE(frustum.intersects(box({0, 0, 12}, 1)));   // behind the camera
+    EXPECT_FALSE(frustum.intersects(box({13, 0, 0}, 1)));   // right of the view
+    EXPECT_FALSE(frustum.intersects(box({0, -13, 0}, 1)));  // below the view
+    EXPECT_FALSE(frustum.intersects(box({0, 0, -95}, 1)));  // beyond the far plane at z = -90
+    EXPECT_FALSE(frustum.intersects(BoundingBox()));
+
+    EXPECT_TRUE(frustum.intersects_sphere({0, 0, 0}, 1));
+    EXPECT_TRUE(frustum.intersects_sphere({11, 0, 0}, 1.5f));
+    EXPECT_FALSE(frustum.intersects_sphere({12, 0, 0}, 1));
+}
+
+TEST(CameraTests, FitToBoundsFramesTheWholeBox) {
+    const BoundingBox bounds(Vector3(2, -1, -3), Vector3(6, 3, 1));
+    Camera camera;
+    camera.set_aspect_ratio(1.0f);
+    camera.fit_to_bounds(bounds);
+
+    EXPECT_NEAR(camera.get_target().x, 4.0f, 1e-5f);
+    EXPECT_NEAR(camera.get_target().y, 1.0f, 1e-5f);
+    EXPECT_NEAR(camera.get_target().z, -1.0f, 1e-5f);
+    EXPECT_GT(camera.get_position().z, bounds.max.z);
+
+    // every corner is inside all six planes
+    const Frustum frustum(camera.get_view_projection_matrix());
+    for (const Vector3& corner : {bounds.min, bounds.max, Vector3(bounds.min.x, bounds.max.y, bounds.max.z),
+                                  Vector3(bounds.max.x, bounds.min.y, bounds.min.z)}) {
+        for (const auto& plane : frustum.get_planes()) {
+            EXPECT_GT(plane.normal.dot(corner) + plane.distance, 0.0f);
+        }
+    }
+}
@@ -0,0 +1,264 @@
+#include "jobs/JobSystem.hpp"
+#include "math/MatrixTransforms.hpp"
+#include "render/FrameProfiler.hpp"
+#include "render/SoftwareRasterizer.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include <gtest/gtest.h>
+
+using namespace di_renderer::graphics;
+using di_renderer::jobs::JobSystem;
+using di_renderer::math::Vector3;
+
+namespace {
+    Vertex make_vertex(const float x, const float y, const float z) {
+        return {{x, y, z}, {1.0f, 1.0f, 1.0f}, {0.0f, 0.0f, 1.0f}, {0.0f, 0.0f}};
+    }
+
+    // Full-viewport quad at depth z with counter-clockwise triangles, lit head-on by light 1
+    std::vector<Vertex> make_quad(const float z, const Vector3& color) {
+        std::vector<Vertex> quad = {make_vertex(-1, -1, z), make_vertex(1, -1, z), make_vertex(1, 1, z),
+                                    make_vertex(-1, 1, z)};
+        for (auto& vertex : quad) {
+            vertex.color = {color.x, color.y, color.z};
+        }
+        return quad;
+    }
+
+    const std::vector<std::uint16_t> QUAD_INDICES = {0, 1, 2, 0, 2, 3};
+
+    SoftwareShading make_head_on_shading() {
+        SoftwareShading shading;
+        shading.light_pos1 = Vector3(0.0f, 0.0f, 1000.0f);
+        return shading;
+    }
+} // namespace
+
+TEST(SoftwareRasterizerTests, QuadCoversEveryPixelOnce) {
+    SoftwareRasterizer rasterizer(67, 45);
+    rasterizer.clear(Vector3(0.0f, 0.0f, 0.0f));
+    const auto quad = make_quad(0.0f, Vector3(1.0f, 1.0f, 1.0f));
+    rasterizer.draw(quad.data(), quad.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), make_head_on_shading());
+
+    // ambient 0.1 plus 0.8 of the head-on light
+    for (int y = 0; y < rasterizer.get_height(); ++y) {
+        for (int x = 0; x < rasterizer.get_width(); ++x) {
+            const auto pixel = rasterizer.get_pixel(x, y);
+            ASSERT_NEAR(pixel[0], 230, 1) << x << ", " << y;
+            ASSERT_FLOAT_EQ(rasterizer.get_depth(x, y), 0.5f);
+        }
+    }
+}
+
+TEST(SoftwareRasterizerTests, CullsBackFacesAndTestsDepth) {
+    SoftwareRasterizer rasterizer(32, 32);
+    rasterizer.clear(Vector3(0.0f, 0.0f, 0.0f));
+    const SoftwareShading shading = make_head_on_shading();
+
+    const std::vector<std::uint16_t> clockwise = {0, 2, 1, 0, 3, 2};
+    const auto back = make_quad(0.0f, Vector3(1.0f, 1.0f, 1.0f));
+    rasterizer.draw(back.data(), back.size(), clockwise.data(), clockwise.size(), shading);
+    EXPECT_EQ(rasterizer.get_pixel(16, 16)[0], 0);
+
+    // the near red quad must win whichever is drawn first
+    const auto near = make_quad(-0.5f, Vector3(1.0f, 0.0f, 0.0f));
+    const auto far = make_quad(0.5f, Vector3(0.0f, 1.0f, 0.0f));
+    rasterizer.draw(near.data(), near.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    rasterizer.draw(far.data(), far.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    EXPECT_GT(rasterizer.get_pixel(16, 16)[0], 200);
+    EXPECT_LT(rasterizer.get_pixel(16, 16)[1], 30);
+
+    rasterizer.clear(Vector3(0.0f, 0.0f, 0.0f));
+    rasterizer.draw(far.data(), far.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    rasterizer.draw(near.data(), near.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    EXPECT_GT(rasterizer.get_pixel(16, 16)[0], 200);
+    EXPECT_FLOAT_EQ(rasterizer.get_depth(16, 16), 0.25f);
+}
+
+TEST(SoftwareRasterizerTests, DiscardsTransparentTexels) {
+    SoftwareRasterizer rasterizer(16, 16);
+    rasterizer.clear(Vector3(0.0f, 0.0f, 1.0f));
+
+    // 1x1 texture with alpha 0 discards everything, depth included
+    SoftwareTexture texture{1, 1, {255, 255, 255, 0}};
+    SoftwareShading shading = make_head_on_shading();
+    shading.texture = &texture;
+    const auto quad = make_quad(0.0f, Vector3(1.0f, 1.0f, 1.0f));
+    rasterizer.draw(quad.data(), quad.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    EXPECT_EQ(rasterizer.get_pixel(8, 8), (std::array<std::uint8_t, 3>{0, 0, 255}));
+    EXPECT_FLOAT_EQ(rasterizer.get_depth(8, 8), 1.0f);
+
+    texture.rgba = {255, 0, 0, 255};
+    rasterizer.draw(quad.data(), quad.size(), QUAD_INDICES.data(), QUAD_INDICES.size(), shading);
+    EXPECT_EQ(rasterizer.get_pixel(8, 8), (std::array<std::uint8_t, 3>{230, 0, 0}));
+}
+
+TEST(SoftwareRasterizerTests, ClipsAtTheNearPlaneAndMatchesAcrossThreadCounts) {
+    // a floor running from behind the camera to far in front of it
+    const auto projection = di_renderer::math::MatrixTransforms::perspective(1.2f, 1.0f, 0.1f, 100.0f);
+    const auto view = di_renderer::math::MatrixTransforms::look_at(Vector3(0, 1, 0), Vector3(0, 0, -10),
+                                                                   Vector3(0, 1, 0));
+    SoftwareShading shading;
+    shading.view_projection = projection * view;
+    shading.light_pos1 = Vector3(0.0f, 10.0f, 0.0f);
+
+    std::vector<Vertex> floor;
+    std::vector<std::uint32_t> indices;
+    for (int row = 0; row < 40; ++row) {
+        for (int column = 0; column < 40; ++column) {
+            const auto base = static_cast<std::uint32_t>(floor.size());
+            const float x = -20.0f + static_cast<float>(column);
+            const float z = 10.0f - (static_cast<float>(row) * 2.0f);
+            for (const auto& [dx, dz] : {std::array<float, 2>{0, 0}, {1, 0}, {1, -2}, {0, -2}}) {
+                Vertex vertex = make_vertex(x + dx, 0.0f, z + dz);
+                vertex.normal = {0.0f, 1.0f, 0.0f};
+                floor.push_back(vertex);
+            }
+            indices.insert(indices.end(), {base, base + 1, base + 2, base, base + 2, base + 3});
+        }
+    }
+
+    std::vector<std::vector<std::uint8_t>> images;
+    for (const std::size_t thread_count : {1, 4}) {
+        JobSystem jobs(thread_count);
+        SoftwareRasterizer rasterizer(96, 64, jobs);
+        rasterizer.clear(Vector3(0.0f, 0.0f, 0.0f));
+        rasterizer.draw(floor.data(), floor.size(), indices.data(), indices.size(), shading);
+        EXPECT_GT(rasterizer.get_pixel(48, 63)[0], 0); // the floor right under the camera
+        EXPECT_EQ(rasterizer.get_pixel(48, 0)[0], 0);  // sky
+        images.push_back(rasterizer.get_pixels());
+    }
+    EXPECT_EQ(images[0], images[1]);
+}
+
+TEST(FrameProfilerTests, PercentileUsesNearestRank) {
+    std::vector<double> values;
+    for (int i = 100; i >= 1; --i) {
+        values.push_back(static_cast<double>(i));
+    }
+    EXPECT_EQ(get_percentile(values, 0.50), 50.0);
+    EXPECT_EQ(get_percentile(values, 0.95), 95.0);
+    EXPECT_EQ(get_percentile(values, 0.99), 99.0);
+    EXPECT_EQ(get_percentile(values, 1.0), 100.0);
+    EXPECT_EQ(get_percentile(values, 0.0), 1.0);
+    EXPECT_EQ(get_percentile({}, 0.5), 0.0);
+}
+
+TEST(FrameProfilerTests, RecordsNothingWhileDisabled) {
+    FrameProfiler profiler;
+    profiler.begin_frame();
+    {
+        const auto timer = profiler.time(FrameStage::DRAW);
+        profiler.count_draw(12, 0);
+    }
+    profiler.end_frame();
+    EXPECT_TRUE(profiler.get_history().empty());
+    EXPECT_EQ(profiler.summarize().frames, 0U);
+}
+
+TEST(FrameProfilerTests, CountsPerFrameAndNestsStagesExclusively) {
+    FrameProfiler profiler;
+    profiler.set_enabled(true);
+
+    profiler.begin_frame();
+    {
+        const auto draw = profiler.time(FrameStage::DRAW);
+        {
+            const auto upload = profiler.time(FrameStage::UPLOAD);
+            profiler.count_upload(1024);
+        }
+        profiler.count_draw(100, 0);
+        profiler.count_draw(0, 30);
+    }
+    profiler.count_meshes(2, 1);
+    profiler.end_frame();
+
+    profiler.begin_frame();
+    profiler.count_draw(5, 0);
+    profiler.end_frame();
+
+    const auto history = profiler.get_history();
+    ASSERT_EQ(history.size(), 2U);
+    const FrameRecord& first = history[0];
+    EXPECT_EQ(first.draw_calls, 2U);
+    EXPECT_EQ(first.triangles, 100U);
+    EXPECT_EQ(first.lines, 30U);
+    EXPECT_EQ(first.uploaded_bytes, 1024U);
+    EXPECT_EQ(first.meshes_drawn, 2U);
+    EXPECT_EQ(first.meshes_culled, 1U);
+    double stages_ms = 0.0;
+    for (const double ms : first.stage_ms) {
+        EXPECT_GE(ms, 0.0);
+        stages_ms += ms;
+    }
+    EXPECT_LE(stages_ms, first.cpu_ms);
+    EXPECT_EQ(history[1].draw_calls, 1U);
+    EXPECT_EQ(history[1].uploaded_bytes, 0U);
+
+    const FrameSummary summary = profiler.summarize();
+    EXPECT_EQ(summary.frames, 2U);
+    EXPECT_EQ(summary.uploaded_bytes, 1024U);
+    EXPECT_EQ(summary.last.triangles, 5U);
+    EXPECT_LE(summary.cpu_p50_ms, summary.cpu_max_ms);
+}
+
+TEST(FrameProfilerTests, AttachesLateGpuResultsAndKeepsALimitedHistory) {
+    FrameProfiler profiler;
+    profiler.set_enabled(true);
+    for (std::size_t i = 0; i < FrameProfiler::HISTORY_SIZE + 10; ++i) {
+        profiler.begin_frame();
+        profiler.end_frame();
+    }
+    const std::uint64_t newest = profiler.get_frame_index() - 1;
+    profiler.set_gpu_time(newest, GpuPass::MESH, 2.0);
+    profiler.set_gpu_time(newest - 1, GpuPass::MESH, 4.0);
+    profiler.set_gpu_time(0, GpuPass::MESH, 100.0);          // already dropped from the history
+    profiler.set_gpu_time(newest + 1, GpuPass::MESH, 100.0); // not recorded yet
+
+    const auto history = profiler.get_history();
+    ASSERT_EQ(history.size(), FrameProfiler::HISTORY_SIZE);
+    EXPECT_EQ(history.front().frame, 10U);
+    EXPECT_EQ(history.back().gpu_ms[0], 2.0);
+    EXPECT_LT(history.back().gpu_ms[1], 0.0);
+
+    const FrameSummary summary = profiler.summarize();
+    EXPECT_EQ(summary.gpu_p50_ms[0], 2.0);
+    EXPECT_LT(summary.gpu_p50_ms[1], 0.0);
+}
+
+TEST(FrameProfilerTests, WritesSummaryAndOneRowPerFrame) {
+    FrameProfiler profiler;
+    profiler.set_enabled(true);
+    for (int i = 0; i < 3; ++i) {
+        profiler.begin_frame();
+        profiler.count_draw(10, 0);
+        profiler.end_frame();
+    }
+    profiler.set_gpu_time(1, GpuPass::MESH, 0.5);
+
+    const std::string filename =
+        (std::filesystem::temp_directory_path() / "di_renderer_frame_stats_test.csv").string();
+    profiler.write_report(filename);
+
+    std::ifstream file(filename);
+    std::vector<std::string> comments;
+    std::vector<std::string> rows;
+    for (std::string line; std::getline(file, line);) {
+        (line.rfind("# ", 0) == 0 ? comments : rows).push_back(line);
+    }
+    std::remove(filename.c_str());
+
+    EXPECT_FALSE(comments.empty());
+    ASSERT_EQ(rows.size(), 4U);
+    EXPECT_EQ(rows[0].rfind("frame,cpu_ms,bounds_ms,", 0), 0U);
+    EXPECT_NE(rows[2].find(",0.5,,1,10,0,0,"), std::string::npos);
+    EXPECT_NE(rows[1].find(",,,1,10,0,0,"), std::string::npos);
+    EXPECT_THROW(profiler.write_report("/nonexistent/dir/stats.csv"), std::runtime_error);
+}